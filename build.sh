@@ -122,7 +122,9 @@ build () {
 runtests () {
     echo "Testing..."
     if [ $TESTS = "ON" ]; then
-        cd build && ctest --output-on-failure -j$JOBS && cd ..
+        # Timing tests (label "timing") depend on machine load; run them
+        # separately with: ctest -L timing
+        cd build && ctest --output-on-failure -j$JOBS -LE timing && cd ..
     fi
 }
 
@@ -101,6 +101,13 @@ public:
     inline void flushReports (){
         latestReport.flush();
     }
+    
+    /// Report the latest episode early if it can no longer change and its
+    /// survey has concluded (for streaming output). See
+    /// Episode::reportIfExpired() for the effect on by-origin measures.
+    inline void reportExpiredEpisode (const Human& human){
+        latestReport.reportIfExpired( human );
+    }
 
     inline const Episode &getLatestReport () const{
         return latestReport;
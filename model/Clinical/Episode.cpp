@@ -37,6 +37,23 @@ void Episode::flush() {
     time = sim::never();
 }
 
+void Episode::reportIfExpired(const Host::Human& human) {
+    // Reports to the current survey could still affect conditions (which
+    // update() would only report later), so wait until it has concluded.
+    // This also skips episodes already reported (surveyPeriod is NOT_USED).
+    if (surveyPeriod >= mon::eventSurveyNumber())
+        return;
+    // Same test as update(), where ts0 will be the current time
+    if (healthSystemMemoryFix ? time + ClinicalModel::hsMemory() <= sim::now()
+            : time + ClinicalModel::hsMemory() < sim::now())
+    {
+        // update() would use the origin at replacement, which is not known yet
+        infectionType = human.withinHostModel->getInfectionType();
+        report();
+        surveyPeriod = mon::NOT_USED;
+    }
+}
+
 
 void Episode::update (const Host::Human& human, Episode::State newState)
 {
@@ -95,6 +95,20 @@ public:
     /// Report anything pending, as on destruction
     void flush();
     
+    /** Report now if update() would start a new episode and the survey
+     * reported to has concluded, instead of waiting for the next episode.
+     * 
+     * Unlike flush(), this leaves time unchanged (the decision tree reads it);
+     * surveyPeriod is set to NOT_USED so that nothing is reported twice. Must
+     * be called between updates.
+     * 
+     * Uncomplicated malaria episodes are reported by the origin of the
+     * human's infection (nUncomp_Indigenous etc.). update() uses the origin
+     * when it replaces the episode; here the origin at the time of this call
+     * is used instead, so these measures can differ from a run without
+     * streaming output. All other measures are unaffected. */
+    void reportIfExpired(const Host::Human& human);
+    
     /** Report an episode, its severity, and any outcomes it entails.
      *
      * @param human The human whose info is being reported
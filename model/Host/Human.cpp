@@ -126,25 +126,84 @@ Human::Human(SimTime dateOfBirth) :
         avail += perHostTransmission.anophEntoAvailability[i];
 }
 
+void SubPopMembership::set( ComponentId id, SimTime expiry )
+{
+    auto it = members.begin();
+    while( it != members.end() && it->id < id ) ++it;
+    if( it != members.end() && it->id == id ) it->expiry = expiry;
+    else members.insert( it, Member{ id, expiry } );
+    mask |= bit( id );
+    nextExpiry = min( nextExpiry, expiry );     // may now be too early; that's fine
+}
+
+bool SubPopMembership::remove( ComponentId id )
+{
+    if( (mask & bit( id )) == 0 ) return false;
+    for( auto it = members.begin(); it != members.end(); ++it ){
+        if( it->id == id ){
+            members.erase( it );
+            update();
+            return true;
+        }
+    }
+    return false;
+}
+
+void SubPopMembership::update()
+{
+    mask = 0;
+    nextExpiry = sim::future();
+    for( const Member& m : members ){
+        mask |= bit( m.id );
+        nextExpiry = min( nextExpiry, m.expiry );
+    }
+}
+
+// Same format as the map<ComponentId,SimTime> used before
+void SubPopMembership::checkpoint( istream& stream )
+{
+    size_t l;
+    l & stream;
+    util::checkpoint::validateListSize( l );
+    members.clear();
+    for( size_t i = 0; i < l; ++i ){
+        ComponentId id( stream );
+        SimTime t = sim::never();
+        t & stream;
+        if( !members.empty() && !(members.back().id < id) )
+            throw util::checkpoint_error( "sub-population memberships not sorted" );
+        members.push_back( Member{ id, t } );
+    }
+    update();
+}
+void SubPopMembership::checkpoint( ostream& stream )
+{
+    members.size() & stream;
+    for( Member& m : members ){
+        m.id & stream;
+        m.expiry & stream;
+    }
+}
+
 void Human::addToCohort(ComponentId id, SimTime duration )
 {
     if( duration <= sim::zero() ) return; // nothing to do
-    subPopExp[id] = sim::nowOrTs1() + duration;
+    subPopExp.set( id, sim::nowOrTs1() + duration );
     cohortSet = mon::updateCohortSet( cohortSet, id, true );
 }
 
 void Human::removeFromCohort(interventions::ComponentId id)
 {
-    subPopExp.erase(id);
+    subPopExp.remove(id);
 }
 
 void Human::removeFirstEvent(interventions::SubPopRemove::RemoveAtCode code )
 {
     const vector<ComponentId>& removeAtList = interventions::removeAtIds[code];
     for( auto it = removeAtList.begin(), end = removeAtList.end(); it != end; ++it ){
-        auto expIt = subPopExp.find( *it );
-        if( expIt != subPopExp.end() ){
-            if( expIt->second >= sim::nowOrTs0() ){
+        const SubPopMembership::Member* member = subPopExp.find( *it );
+        if( member != nullptr ){
+            if( member->expiry >= sim::nowOrTs0() ){
                 // removeFirstEvent() is used for onFirstBout, onFirstTreatment
                 // and onFirstInfection cohort options. Health system memory must
                 // be reset for this to work properly; in theory the memory should
@@ -154,28 +213,22 @@ void Human::removeFirstEvent(interventions::SubPopRemove::RemoveAtCode code )
                 // report removal due to first infection/bout/treatment
                 mon::reportEventMHI( mon::MHR_SUB_POP_REM_FIRST_EVENT, *this, 1 );
             }
-            cohortSet = mon::updateCohortSet( cohortSet, expIt->first, false );
+            cohortSet = mon::updateCohortSet( cohortSet, *it, false );
             // remove (affects reporting, restrictToSubPop and cumulative deployment):
-            subPopExp.erase( expIt );
+            subPopExp.remove( *it );
         }
     }
 }
 
 void Human::updateCohortSet()
 {
-    // check sub-pop expiry
-    for( auto expIt = subPopExp.begin(), expEnd = subPopExp.end(); expIt != expEnd; ) {
-        if( !(expIt->second >= sim::ts0()) ){       // membership expired
-            // don't flush reports
-            // report removal due to expiry
-            mon::reportEventMHI( mon::MHR_SUB_POP_REM_TOO_OLD, *this, 1 );
-            cohortSet = mon::updateCohortSet( cohortSet, expIt->first, false );
-            // erase element, but continue iteration
-            expIt = subPopExp.erase( expIt );
-        }else{
-            ++expIt;
-        }
-    }
+    // check sub-pop expiry (memberships with expiry < ts0)
+    subPopExp.removeExpired( sim::ts0(), [this]( ComponentId id ){
+        // don't flush reports
+        // report removal due to expiry
+        mon::reportEventMHI( mon::MHR_SUB_POP_REM_TOO_OLD, *this, 1 );
+        cohortSet = mon::updateCohortSet( cohortSet, id, false );
+    } );
 }
 
 double Human::getAvailability() const
@@ -221,10 +274,11 @@ void summarize(Human &human, bool surveyOnlyNewEp) {
         return;
     }
     
-    mon::reportStatMHI( mon::MHR_HOSTS, human, 1 );
-    mon::reportStatMHF( mon::MHF_AGE, human, sim::inYears(human.age(sim::now())) );
-    bool patent = human.withinHostModel->summarize (human);
-    human.infIncidence->summarize (human);
+    mon::HostSummary summary( human );
+    summary.reportI( mon::MHR_HOSTS, 1 );
+    summary.reportF( mon::MHF_AGE, sim::inYears(human.age(sim::now())) );
+    bool patent = human.withinHostModel->summarize (human, summary);
+    human.infIncidence->summarize (summary);
     
     if( patent && mon::isReported() ){
         // this should happen after all other reporting!
@@ -254,8 +308,12 @@ void update(Human &human, Transmission::TransmissionModel& transmission)
     // age1 we should stick with it.
     double age1 = sim::inYears(human.age(sim::ts1()));
 
+    // Per-genotype EIR buffers are reused across humans and steps (the
+    // transmission model only assigns to them), so that in steady state this
+    // update does no heap allocation. Thread-local for use by parallel updates.
+    static thread_local vector<double> EIR_per_genotype_i, EIR_per_genotype_l;
+
     // age1 used only in PerHost::relativeAvailabilityAge(); difference to age0 should be minor
-    vector<double> EIR_per_genotype_i, EIR_per_genotype_l;
     transmission.getEIR(human, age0, age1, EIR_per_genotype_i, EIR_per_genotype_l);
 
     double EIR_i = util::vectors::sum(EIR_per_genotype_i);
@@ -42,6 +42,69 @@ namespace Transmission {
 
 namespace Host {
 
+/** Sub-populations of which a human is a member, with expiry dates.
+ *
+ * Humans are usually members of few sub-populations, so members are kept in
+ * a small array sorted by component id. A bit mask (bit id % 64) rejects most
+ * non-members without a search, and the earliest expiry date lets expiry be
+ * skipped until some membership may have expired. */
+class SubPopMembership {
+public:
+    struct Member {
+        interventions::ComponentId id;
+        SimTime expiry;
+    };
+    
+    /// Get the entry for sub-population id, or nullptr if not a member
+    inline const Member* find( interventions::ComponentId id ) const{
+        if( (mask & bit( id )) == 0 ) return nullptr;
+        for( const Member& m : members ){
+            if( m.id == id ) return &m;
+        }
+        return nullptr;
+    }
+    
+    /// Become a member of id until expiry (or update the expiry date)
+    void set( interventions::ComponentId id, SimTime expiry );
+    
+    /// Remove membership of id. Returns true if it was a member.
+    bool remove( interventions::ComponentId id );
+    
+    /** Remove all memberships expiring before date, in order of id, calling
+     * f(id) for each. */
+    template<typename F>
+    void removeExpired( SimTime date, F f ){
+        if( !(nextExpiry < date) ) return;     // nothing expired
+        size_t j = 0;
+        for( size_t i = 0; i < members.size(); ++i ){
+            if( members[i].expiry < date ) f( members[i].id );
+            else members[j++] = members[i];
+        }
+        members.erase( members.begin() + j, members.end() );
+        update();
+    }
+    
+    /// Checkpointing
+    void checkpoint( istream& stream );
+    void checkpoint( ostream& stream );
+    template<class S>
+    void operator& (S& stream) {
+        checkpoint (stream);
+    }
+    
+private:
+    static inline uint64_t bit( interventions::ComponentId id ){
+        return static_cast<uint64_t>(1) << (id.id & 63);
+    }
+    // Recalculate mask and nextExpiry
+    void update();
+    
+    vector<Member> members;     // sorted by id
+    uint64_t mask = 0;          // bit( id ) of each member
+    // No membership expires before this (sim::future() if none)
+    SimTime nextExpiry = sim::future();
+};
+
 /** Interface to all sub-models storing data per-human individual.
  *
  * Still contains some data, but most is now contained in sub-models. */
@@ -140,17 +203,15 @@ private:
     /** This lists sub-populations of which the human is a member together with
     * expiry time.
     * 
-    * Definition: a human is in sub-population p if subPopExp.contains(p) and,
-    * for t=subPopExp[p], t > sim::now() (at the time of intervention
+    * Definition: a human is in sub-population p if subPopExp.find(p) is an
+    * entry and, for its expiry t, t > sim::now() (at the time of intervention
     * deployment) or t > sim::ts0() (equiv t >= sim::ts1()) during human update.
     * 
     * NOTE: this discrepancy is because intervention deployment effectively
     * happens at the end of a time step and we want a duration of 1 time step to
     * mean 1 intervention deployment (that where the human becomes a member) and
     * 1 human update (the next). */
-    //TODO(optimisation): it might be better to instead store for each
-    // ComponentId of interest the set of humans who are members
-    std::map<interventions::ComponentId,SimTime> subPopExp;
+    SubPopMembership subPopExp;
 };
 
 void summarize(Human &human, bool surveyOnlyNewEp);
@@ -162,9 +223,9 @@ inline SimTime Human::age( SimTime time ) const {
 }
 
 inline bool Human::isInSubPop( interventions::ComponentId id ) const {
-    auto it = subPopExp.find( id );
-    if( it == subPopExp.end() ) return false;   // no history of membership
-    else return it->second >= sim::nowOrTs0();   // added: has expired?
+    const SubPopMembership::Member* m = subPopExp.find( id );
+    if( m == nullptr ) return false;   // no history of membership
+    else return m->expiry >= sim::nowOrTs0();   // added: has expired?
 }
 
 inline uint32_t Human::getCohortSet() const { 
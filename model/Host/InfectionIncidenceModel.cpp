@@ -169,8 +169,8 @@ double LogNormalMAII::getAvailabilityFactor(LocalRng& rng, double baseAvailabili
 		     baseline_avail_shape_param);
 }
 
-void InfectionIncidenceModel::summarize (const Host::Human& human) {
-    mon::reportStatMHF( mon::MHF_EXPECTED_INFECTED, human, m_pInfected );
+void InfectionIncidenceModel::summarize (mon::HostSummary& summary) {
+    summary.reportF( mon::MHF_EXPECTED_INFECTED, m_pInfected );
 }
 
 
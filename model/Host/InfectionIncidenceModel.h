@@ -28,6 +28,9 @@
 
 namespace OM {
     class Parameters;
+namespace mon {
+    class HostSummary;
+}
 namespace Host {
     class Human;
 
@@ -89,7 +92,7 @@ public:
   virtual double getAvailabilityFactor(LocalRng& rng, double baseAvailability = 1.0);
   
   /// Output _pinfected to the summary
-  void summarize (const Host::Human& human);
+  void summarize (mon::HostSummary& summary);
   
     /** Calculate the expected number of new infections to introduce.
    * 
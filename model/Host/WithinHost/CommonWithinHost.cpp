@@ -24,6 +24,7 @@
 #include "Host/WithinHost/Diagnostic.h"
 #include "Host/WithinHost/Genotypes.h"
 #include "Host/WithinHost/Pathogenesis/PathogenesisModel.h"
+#include "PkPd/DecayBatch.h"
 #include "util/errors.h"
 #include "util/ModelOptions.h"
 #include "util/AgeGroupInterpolation.h"
@@ -44,6 +45,8 @@ double minHetMassMult = std::numeric_limits<double>::signaling_NaN();
 util::AgeGroupInterpolator massByAge;
 
 bool reportInfectedOrPatentInfected = false;
+// Reused when sampling genotypes of new infections
+static thread_local Genotypes::Sampler genotypeSampler;
 
 // -----  Initialization  -----
 
@@ -114,6 +117,9 @@ void CommonWithinHost::treatPkPd(size_t schedule, size_t dosage, double age, dou
     double mass = massByAge.eval( age ) * hetMassMultiplier;
     pkpdModel.prescribe( schedule, dosage, age, mass, delay_d );
 }
+void CommonWithinHost::addToDecayBatch( PkPd::DecayBatch& batch ){
+    batch.add( pkpdModel );
+}
 void CommonWithinHost::clearImmunity() {
     for(auto inf = infections.begin(); inf != infections.end(); ++inf) {
         (*inf)->clearImmunity();
@@ -138,7 +144,7 @@ void CommonWithinHost::importInfection(LocalRng& rng, int origin){
 // -----  Density calculations  -----
 
 void CommonWithinHost::update(Host::Human &human, LocalRng& rng, int &nNewInfs_i, int &nNewInfs_l, 
-        vector<double>& genotype_weights_i, vector<double>& genotype_weights_l, double ageInYears)
+        const vector<double>& genotype_weights_i, const vector<double>& genotype_weights_l, double ageInYears)
 {
     // Note: adding infections at the beginning of the update instead of the end
     // shouldn't be significant since before latentp delay nothing is updated.
@@ -150,8 +156,9 @@ void CommonWithinHost::update(Host::Human &human, LocalRng& rng, int &nNewInfs_i
     assert( numInfs>=0 && numInfs<=MAX_INFECTIONS );
 
     int nNewInfsDiscarded = 0;
+    if( nNewInfs_i > 0 ) genotypeSampler.prepare( genotype_weights_i );
     for( int i=0; i<nNewInfs_i; ++i ) {
-        uint32_t genotype = Genotypes::sampleGenotype(rng, genotype_weights_i);
+        uint32_t genotype = genotypeSampler.sample(rng);
 
         // If opt_vaccine_genotype is true the infection is discarded with probability 1-vaccineFactor
         if( opt_vaccine_genotype )
@@ -170,8 +177,9 @@ void CommonWithinHost::update(Host::Human &human, LocalRng& rng, int &nNewInfs_i
     numInfs += nNewInfs_i;
 
     nNewInfsDiscarded = 0;
+    if( nNewInfs_l > 0 ) genotypeSampler.prepare( genotype_weights_l );
     for( int i=0; i<nNewInfs_l; ++i ) {
-        uint32_t genotype = Genotypes::sampleGenotype(rng, genotype_weights_l);
+        uint32_t genotype = genotypeSampler.sample(rng);
 
         // If opt_vaccine_genotype is true the infection is discarded with probability 1-vaccineFactor
         if( opt_vaccine_genotype )
@@ -305,40 +313,40 @@ struct InfGenotypeSorter {
     }
 } infGenotypeSorter;
 
-bool CommonWithinHost::summarize( Host::Human& human )const{
-    pathogenesisModel->summarize( human );
-    pkpdModel.summarize( human );
+bool CommonWithinHost::summarize( Host::Human& human, mon::HostSummary& summary ){
+    pathogenesisModel->summarize( summary );
+    pkpdModel.summarize( summary );
     
     // If the number of infections is 0 and parasite density is positive we default to Indigenous
     if( infections.size() > 0 ){
-        mon::reportStatMHI( mon::MHR_INFECTED_HOSTS, human, 1 );
+        summary.reportI( mon::MHR_INFECTED_HOSTS, 1 );
         if(infectionType == InfectionOrigin::Indigenous)
-            mon::reportStatMHI( mon::MHR_INFECTED_HOSTS_INDIGENOUS, human, 1 );
+            summary.reportI( mon::MHR_INFECTED_HOSTS_INDIGENOUS, 1 );
         else if(infectionType == InfectionOrigin::Introduced)
-            mon::reportStatMHI( mon::MHR_INFECTED_HOSTS_INTRODUCED, human, 1 );
+            summary.reportI( mon::MHR_INFECTED_HOSTS_INTRODUCED, 1 );
         else
-            reportStatMHI( mon::MHR_INFECTED_HOSTS_IMPORTED, human, 1 );
+            summary.reportI( mon::MHR_INFECTED_HOSTS_IMPORTED, 1 );
 
         if( reportInfectedOrPatentInfected ){
             for(auto inf = infections.begin(); inf != infections.end(); ++inf)
             {
                 uint32_t genotype = (*inf)->genotype();
-                mon::reportStatMHGI( mon::MHR_INFECTIONS, human, genotype, 1 );
+                summary.reportGI( mon::MHR_INFECTIONS, genotype, 1 );
                 if((*inf)->origin() == InfectionOrigin::Indigenous)
-                    mon::reportStatMHGI( mon::MHR_INFECTIONS_INDIGENOUS, human, genotype, 1 );
+                    summary.reportGI( mon::MHR_INFECTIONS_INDIGENOUS, genotype, 1 );
                 else if((*inf)->origin() == InfectionOrigin::Introduced)
-                    mon::reportStatMHGI( mon::MHR_INFECTIONS_INTRODUCED, human, genotype, 1 );
+                    summary.reportGI( mon::MHR_INFECTIONS_INTRODUCED, genotype, 1 );
                 else
-                    mon::reportStatMHGI( mon::MHR_INFECTIONS_IMPORTED, human, genotype, 1 );
+                    summary.reportGI( mon::MHR_INFECTIONS_IMPORTED, genotype, 1 );
 
                 if( diagnostics::monitoringDiagnostic().isPositive( human.rng, (*inf)->getDensity(), std::numeric_limits<double>::quiet_NaN() ) ){
-                    mon::reportStatMHGI( mon::MHR_PATENT_INFECTIONS, human, genotype, 1 );
+                    summary.reportGI( mon::MHR_PATENT_INFECTIONS, genotype, 1 );
                     if((*inf)->origin() == InfectionOrigin::Indigenous)
-                        mon::reportStatMHGI( mon::MHR_PATENT_INFECTIONS_INDIGENOUS, human, genotype, 1 );
+                        summary.reportGI( mon::MHR_PATENT_INFECTIONS_INDIGENOUS, genotype, 1 );
                     else if((*inf)->origin() == InfectionOrigin::Introduced)
-                        mon::reportStatMHGI( mon::MHR_PATENT_INFECTIONS_INTRODUCED, human, genotype, 1 );
+                        summary.reportGI( mon::MHR_PATENT_INFECTIONS_INTRODUCED, genotype, 1 );
                     else
-                        mon::reportStatMHGI( mon::MHR_PATENT_INFECTIONS_IMPORTED, human, genotype, 1 );
+                        summary.reportGI( mon::MHR_PATENT_INFECTIONS_IMPORTED, genotype, 1 );
                 }
             }
         }
@@ -360,10 +368,10 @@ bool CommonWithinHost::summarize( Host::Human& human )const{
                     ++inf;
                 }while( inf != sortedInfs.end() && (*inf)->genotype() == genotype );
                 // we had at least one infection of this genotype
-                mon::reportStatMHGI( mon::MHR_INFECTED_GENOTYPE, human, genotype, 1 );
+                summary.reportGI( mon::MHR_INFECTED_GENOTYPE, genotype, 1 );
                 if( diagnostics::monitoringDiagnostic().isPositive(human.rng, dens, std::numeric_limits<double>::quiet_NaN()) ){
-                    mon::reportStatMHGI( mon::MHR_PATENT_GENOTYPE, human, genotype, 1 );
-                    mon::reportStatMHGF( mon::MHF_LOG_DENSITY_GENOTYPE, human, genotype, log(dens) );
+                    summary.reportGI( mon::MHR_PATENT_GENOTYPE, genotype, 1 );
+                    summary.reportGF( mon::MHF_LOG_DENSITY_GENOTYPE, genotype, log(dens) );
                 }
             }
         }
@@ -373,18 +381,18 @@ bool CommonWithinHost::summarize( Host::Human& human )const{
     // (and are applied after update()), thus infections.size() may be 0 while
     // totalDensity > 0. Here we report the last calculated density.
     if( diagnostics::monitoringDiagnostic().isPositive(human.rng, totalDensity, std::numeric_limits<double>::quiet_NaN()) ){
-        mon::reportStatMHI( mon::MHR_PATENT_HOSTS, human, 1 );
+        summary.reportI( mon::MHR_PATENT_HOSTS, 1 );
         if(infectionType == InfectionOrigin::Imported)
-            mon::reportStatMHI( mon::MHR_PATENT_HOSTS_IMPORTED, human, 1 );
+            summary.reportI( mon::MHR_PATENT_HOSTS_IMPORTED, 1 );
         else if(infectionType == InfectionOrigin::Introduced)
-            mon::reportStatMHI( mon::MHR_PATENT_HOSTS_INTRODUCED, human, 1 );
+            summary.reportI( mon::MHR_PATENT_HOSTS_INTRODUCED, 1 );
         else if(infectionType == InfectionOrigin::Indigenous)
-            mon::reportStatMHI( mon::MHR_PATENT_HOSTS_INDIGENOUS, human, 1 );
+            summary.reportI( mon::MHR_PATENT_HOSTS_INDIGENOUS, 1 );
 
         if(totalDensity == 0.0)
-            mon::reportStatMHF( mon::MHF_LOG_DENSITY, human, 0.0);
+            summary.reportF( mon::MHF_LOG_DENSITY, 0.0);
         else
-            mon::reportStatMHF( mon::MHF_LOG_DENSITY, human, log(totalDensity) );
+            summary.reportF( mon::MHF_LOG_DENSITY, log(totalDensity) );
         return true;    // patent
     }
     return false;       // not patent
@@ -49,10 +49,11 @@ public:
     virtual void importInfection(LocalRng& rng, int origin);
     
     virtual void treatPkPd(size_t schedule, size_t dosage, double age, double delay_d);
+    virtual void addToDecayBatch( PkPd::DecayBatch& batch );
     virtual void clearImmunity();
     
     virtual void update(Host::Human &human, LocalRng& rng, int &nNewInfs_i, int &nNewInfs_l, 
-        vector<double>& genotype_weights_i, vector<double>& genotype_weights_l, double ageInYears);
+        const vector<double>& genotype_weights_i, const vector<double>& genotype_weights_l, double ageInYears);
     
     virtual void addProphylacticEffects(const vector<double>& pClearanceByTime);
     
@@ -67,7 +68,7 @@ public:
     static CommonInfection* (* checkpointedInfection) (istream& stream);
     //@}
     
-    virtual bool summarize( Host::Human& human )const;
+    virtual bool summarize( Host::Human& human, mon::HostSummary& summary );
     
 protected:
     virtual void clearInfections( Treatments::Stages stage );
@@ -28,6 +28,7 @@
 #include "util/ModelOptions.h"
 #include "util/StreamValidator.h"
 #include "util/errors.h"
+#include <algorithm>
 #include <cassert>
 
 using namespace std;
@@ -37,6 +38,8 @@ namespace WithinHost {
 
 extern bool bugfix_max_dens;    // DescriptiveInfection.cpp
 bool reportPatentInfected = false;
+// Reused when sampling genotypes of new infections
+static thread_local Genotypes::Sampler genotypeSampler;
 // -----  Initialization  -----
 
 void DescriptiveWithinHostModel::initDescriptive(){
@@ -60,16 +63,12 @@ void DescriptiveWithinHostModel::loadInfection(istream& stream) {
 }
 
 void DescriptiveWithinHostModel::clearInfections( Treatments::Stages stage ){
-    for(auto inf = infections.begin(); inf != infections.end();) {
-        if( stage == Treatments::BOTH ||
-            (stage == Treatments::LIVER && !inf->bloodStage()) ||
-            (stage == Treatments::BLOOD && inf->bloodStage())
-        ){
-            inf = infections.erase( inf );
-        }else{
-            ++inf;
-        }
-    }
+    infections.erase( remove_if( infections.begin(), infections.end(),
+        [stage]( const DescriptiveInfection& inf ){
+            return stage == Treatments::BOTH ||
+                (stage == Treatments::LIVER && !inf.bloodStage()) ||
+                (stage == Treatments::BLOOD && inf.bloodStage());
+        } ), infections.end() );
     numInfs = infections.size();
 }
 
@@ -99,7 +98,7 @@ void DescriptiveWithinHostModel::importInfection(LocalRng& rng, int origin){
 // -----  Density calculations  -----
 
 void DescriptiveWithinHostModel::update(Host::Human &human, LocalRng& rng, int &nNewInfs_i, int &nNewInfs_l, 
-        vector<double>& genotype_weights_i, vector<double>& genotype_weights_l, double ageInYears)
+        const vector<double>& genotype_weights_i, const vector<double>& genotype_weights_l, double ageInYears)
 {
     // Note: adding infections at the beginning of the update instead of the end
     // shouldn't be significant since before latentp delay nothing is updated.
@@ -111,8 +110,9 @@ void DescriptiveWithinHostModel::update(Host::Human &human, LocalRng& rng, int &
 
     numInfs += nNewInfs_i;
     assert( numInfs>=0 && numInfs<=MAX_INFECTIONS );
+    if( nNewInfs_i > 0 ) genotypeSampler.prepare( genotype_weights_i );
     for( int i=0; i<nNewInfs_i; ++i ) {
-        uint32_t genotype = Genotypes::sampleGenotype(rng, genotype_weights_i);
+        uint32_t genotype = genotypeSampler.sample(rng);
 
         // If opt_vaccine_genotype is true the infection is discarded with probability 1-vaccineFactor
         if( opt_vaccine_genotype )
@@ -128,8 +128,9 @@ void DescriptiveWithinHostModel::update(Host::Human &human, LocalRng& rng, int &
 
     numInfs += nNewInfs_l;
     assert( numInfs>=0 && numInfs<=MAX_INFECTIONS );
+    if( nNewInfs_l > 0 ) genotypeSampler.prepare( genotype_weights_l );
     for( int i=0; i<nNewInfs_l; ++i ) {
-        uint32_t genotype = Genotypes::sampleGenotype(rng, genotype_weights_l);
+        uint32_t genotype = genotypeSampler.sample(rng);
 
         // If opt_vaccine_genotype is true the infection is discarded with probability 1-vaccineFactor
         if( opt_vaccine_genotype )
@@ -151,8 +152,27 @@ void DescriptiveWithinHostModel::update(Host::Human &human, LocalRng& rng, int &
 
     bool treatmentLiver = treatExpiryLiver > sim::ts0();
     bool treatmentBlood = treatExpiryBlood > sim::ts0();
+    
+    // Terms common to all infections of this host:
+    double stdlog = DescriptiveInfection::densityStdLog( m_cumulative_h );
+    double bsvFactor = opt_vaccine_genotype ? 0.0 :
+        human.vaccine.getFactor(interventions::Vaccine::BSV, 0);
+    
+    // Cache total density for infectiousness calculations
+    int y_lag_i = sim::moduloSteps(sim::ts1(), y_lag_len);
+    double *y_lag_i_now = &m_y_lag_i[y_lag_i * Genotypes::N()];
+    double *y_lag_l_now = &m_y_lag_l[y_lag_i * Genotypes::N()];
+    for( size_t g = 0; g < Genotypes::N(); ++g )
+    {
+        y_lag_i_now[g] = 0.0;
+        y_lag_l_now[g] = 0.0;
+    }
+    int nImported = 0, nIntroduced = 0, nIndigenous = 0;
 
-    for(auto inf = infections.begin(); inf != infections.end();) {
+    // Update all infections in one pass, compacting the vector in place
+    // (preserving order) as infections terminate.
+    auto out = infections.begin();
+    for(auto inf = infections.begin(); inf != infections.end(); ++inf) {
         //NOTE: it would be nice to combine this code with that in
         // CommonWithinHost.cpp, but a few changes would be needed:
         // INNATE_MAX_DENS and MAX_DENS_CORRECTION would need to be required
@@ -163,7 +183,6 @@ void DescriptiveWithinHostModel::update(Host::Human &human, LocalRng& rng, int &
         if ( inf->expired() /* infection has self-terminated */ ||
             (inf->bloodStage() ? treatmentBlood : treatmentLiver) )
         {
-            inf=infections.erase(inf);
             numInfs--;
             continue;
         }
@@ -172,9 +191,10 @@ void DescriptiveWithinHostModel::update(Host::Human &human, LocalRng& rng, int &
         // See MAX_DENS_CORRECTION in DescriptiveInfection.cpp.
         double infStepMaxDens = timeStepMaxDensity;
         double immSurvFact = immunitySurvivalFactor(ageInYears, inf->cumulativeExposureJ());
-        double bsvFactor = human.vaccine.getFactor(interventions::Vaccine::BSV, opt_vaccine_genotype? inf->genotype() : 0);
+        if( opt_vaccine_genotype )
+            bsvFactor = human.vaccine.getFactor(interventions::Vaccine::BSV, inf->genotype());
 
-        inf->determineDensities(rng, m_cumulative_h, infStepMaxDens, immSurvFact, _innateImmSurvFact, bsvFactor);
+        inf->determineDensities(rng, stdlog, infStepMaxDens, immSurvFact, _innateImmSurvFact, bsvFactor);
 
         if (bugfix_max_dens)
             infStepMaxDens = std::max(infStepMaxDens, timeStepMaxDensity);
@@ -185,9 +205,20 @@ void DescriptiveWithinHostModel::update(Host::Human &human, LocalRng& rng, int &
         if( !inf->isHrp2Deficient() ){
             hrp2Density += density;
         }
+        
+        if(inf->origin() == InfectionOrigin::Imported)
+            y_lag_i_now[inf->genotype()] += density;
+        else
+            y_lag_l_now[inf->genotype()] += density;
+
+        if(inf->origin() == InfectionOrigin::Indigenous) nIndigenous++;
+        else if(inf->origin() == InfectionOrigin::Introduced) nIntroduced++;
+        else nImported++;
 
-        ++inf;
+        if( out != inf ) *out = std::move( *inf );
+        ++out;
     }
+    infections.erase( out, infections.end() );
     
     // As in AJTMH p22, cumulative_h (X_h + 1) doesn't include infections added
     // this time-step and cumulative_Y only includes past densities.
@@ -197,28 +228,6 @@ void DescriptiveWithinHostModel::update(Host::Human &human, LocalRng& rng, int &
     util::streamValidate( totalDensity );
     util::streamValidate( hrp2Density );
     assert( (std::isfinite)(totalDensity) );        // inf probably wouldn't be a problem but NaN would be
-    
-    // Cache total density for infectiousness calculations
-    int y_lag_i = sim::moduloSteps(sim::ts1(), y_lag_len);
-
-    for( size_t g = 0; g < Genotypes::N(); ++g )
-    {
-        m_y_lag_i[y_lag_i * Genotypes::N() + g] = 0.0;
-        m_y_lag_l[y_lag_i * Genotypes::N() + g] = 0.0;
-    }
-
-    int nImported = 0, nIntroduced = 0, nIndigenous = 0;
-    for( auto inf = infections.begin(); inf != infections.end(); ++inf )
-    {
-        if(inf->origin() == InfectionOrigin::Imported)
-            m_y_lag_i[y_lag_i * Genotypes::N() + inf->genotype()] += inf->getDensity();
-        else
-            m_y_lag_l[y_lag_i * Genotypes::N() + inf->genotype()] += inf->getDensity();
-
-        if(inf->origin() == InfectionOrigin::Indigenous) nIndigenous++;
-        else if(inf->origin() == InfectionOrigin::Introduced) nIntroduced++;
-        else nImported++;
-    }
 
     /* The rules are:
     - Imported only if all infections are imported
@@ -242,18 +251,18 @@ void DescriptiveWithinHostModel::update(Host::Human &human, LocalRng& rng, int &
 
 // -----  Summarize  -----
 
-bool DescriptiveWithinHostModel::summarize( Host::Human& human )const{
-    pathogenesisModel->summarize( human );
+bool DescriptiveWithinHostModel::summarize( Host::Human& human, mon::HostSummary& summary ){
+    pathogenesisModel->summarize( summary );
     
     // If the number of infections is 0 and parasite density is positive we default to Indigenous
     if( infections.size() > 0 ){
-        mon::reportStatMHI( mon::MHR_INFECTED_HOSTS, human, 1 );
+        summary.reportI( mon::MHR_INFECTED_HOSTS, 1 );
         if(infectionType == InfectionOrigin::Indigenous)
-            mon::reportStatMHI( mon::MHR_INFECTED_HOSTS_INDIGENOUS, human, 1 );
+            summary.reportI( mon::MHR_INFECTED_HOSTS_INDIGENOUS, 1 );
         else if(infectionType == InfectionOrigin::Introduced)
-            mon::reportStatMHI( mon::MHR_INFECTED_HOSTS_INTRODUCED, human, 1 );
+            summary.reportI( mon::MHR_INFECTED_HOSTS_INTRODUCED, 1 );
         else
-            reportStatMHI( mon::MHR_INFECTED_HOSTS_IMPORTED, human, 1 );
+            summary.reportI( mon::MHR_INFECTED_HOSTS_IMPORTED, 1 );
 
         int nImported = 0, nIntroduced = 0, nIndigenous = 0;
         for( auto inf = infections.begin(); inf != infections.end(); ++inf )
@@ -265,23 +274,23 @@ bool DescriptiveWithinHostModel::summarize( Host::Human& human )const{
 
         // (patent) infections are reported by genotype, even though we don't have
         // genotype in this model
-        mon::reportStatMHGI( mon::MHR_INFECTIONS, human, 0, infections.size() );
-        mon::reportStatMHGI( mon::MHR_INFECTIONS_IMPORTED, human, 0, nImported );
-        mon::reportStatMHGI( mon::MHR_INFECTIONS_INTRODUCED, human, 0, nIntroduced );
-        mon::reportStatMHGI( mon::MHR_INFECTIONS_INDIGENOUS, human, 0, nIndigenous );
+        summary.reportGI( mon::MHR_INFECTIONS, 0, infections.size() );
+        summary.reportGI( mon::MHR_INFECTIONS_IMPORTED, 0, nImported );
+        summary.reportGI( mon::MHR_INFECTIONS_INTRODUCED, 0, nIntroduced );
+        summary.reportGI( mon::MHR_INFECTIONS_INDIGENOUS, 0, nIndigenous );
 
         if( reportPatentInfected ){
-            for(std::list<DescriptiveInfection>::const_iterator inf = infections.begin(); inf != infections.end(); ++inf)
+            for(auto inf = infections.begin(); inf != infections.end(); ++inf)
             {
                 if( diagnostics::monitoringDiagnostic().isPositive( human.rng, inf->getDensity(), std::numeric_limits<double>::quiet_NaN() ) )
                 {
-                    mon::reportStatMHGI( mon::MHR_PATENT_INFECTIONS, human, 0, 1 );
+                    summary.reportGI( mon::MHR_PATENT_INFECTIONS, 0, 1 );
                     if(inf->origin() == InfectionOrigin::Indigenous)
-                        mon::reportStatMHGI( mon::MHR_PATENT_INFECTIONS_INDIGENOUS, human, 0, 1 );
+                        summary.reportGI( mon::MHR_PATENT_INFECTIONS_INDIGENOUS, 0, 1 );
                     else if(inf->origin() == InfectionOrigin::Introduced)
-                        mon::reportStatMHGI( mon::MHR_PATENT_INFECTIONS_INTRODUCED, human, 0, 1 );
+                        summary.reportGI( mon::MHR_PATENT_INFECTIONS_INTRODUCED, 0, 1 );
                     else
-                        mon::reportStatMHGI( mon::MHR_PATENT_INFECTIONS_IMPORTED, human, 0, 1 );
+                        summary.reportGI( mon::MHR_PATENT_INFECTIONS_IMPORTED, 0, 1 );
                 }
             }
         }
@@ -294,10 +303,10 @@ bool DescriptiveWithinHostModel::summarize( Host::Human& human )const{
             
             for( auto gtype: dens_by_gtype ){
                 // we had at least one infection of this genotype
-                mon::reportStatMHGI( mon::MHR_INFECTED_GENOTYPE, human, gtype.first, 1 );
+                summary.reportGI( mon::MHR_INFECTED_GENOTYPE, gtype.first, 1 );
                 if( diagnostics::monitoringDiagnostic().isPositive(human.rng, gtype.second, std::numeric_limits<double>::quiet_NaN()) ){
-                    mon::reportStatMHGI( mon::MHR_PATENT_GENOTYPE, human, gtype.first, 1 );
-                    mon::reportStatMHGF( mon::MHF_LOG_DENSITY_GENOTYPE, human, gtype.first, log(gtype.second) );
+                    summary.reportGI( mon::MHR_PATENT_GENOTYPE, gtype.first, 1 );
+                    summary.reportGF( mon::MHF_LOG_DENSITY_GENOTYPE, gtype.first, log(gtype.second) );
                 }
             }
         }
@@ -307,16 +316,16 @@ bool DescriptiveWithinHostModel::summarize( Host::Human& human )const{
     // (and are applied after update()), thus infections.size() may be 0 while
     // totalDensity > 0. Here we report the last calculated density.
     if( diagnostics::monitoringDiagnostic().isPositive(human.rng, totalDensity, std::numeric_limits<double>::quiet_NaN()) ){
-        mon::reportStatMHI( mon::MHR_PATENT_HOSTS, human, 1 );
+        summary.reportI( mon::MHR_PATENT_HOSTS, 1 );
         if(infectionType == InfectionOrigin::Imported)
-            mon::reportStatMHI( mon::MHR_PATENT_HOSTS_IMPORTED, human, 1 );
+            summary.reportI( mon::MHR_PATENT_HOSTS_IMPORTED, 1 );
         else if(infectionType == InfectionOrigin::Introduced)
-            mon::reportStatMHI( mon::MHR_PATENT_HOSTS_INTRODUCED, human, 1 );
+            summary.reportI( mon::MHR_PATENT_HOSTS_INTRODUCED, 1 );
         else if(infectionType == InfectionOrigin::Indigenous)
-            mon::reportStatMHI( mon::MHR_PATENT_HOSTS_INDIGENOUS, human, 1 );
+            summary.reportI( mon::MHR_PATENT_HOSTS_INDIGENOUS, 1 );
 
         if(totalDensity > 1e-10)
-            mon::reportStatMHF( mon::MHF_LOG_DENSITY, human, log(totalDensity) );
+            summary.reportF( mon::MHF_LOG_DENSITY, log(totalDensity) );
         return true;    // patent
     }
     return false;       // not patent
@@ -50,9 +50,9 @@ public:
     virtual void clearImmunity();
     
     virtual void update(Host::Human &human, LocalRng& rng, int &nNewInfs_i, int &nNewInfs_l, 
-        vector<double>& genotype_weights_i, vector<double>& genotype_weights_l, double ageInYears);
+        const vector<double>& genotype_weights_i, const vector<double>& genotype_weights_l, double ageInYears);
     
-    virtual bool summarize( Host::Human& human )const;
+    virtual bool summarize( Host::Human& human, mon::HostSummary& summary );
     
 protected:
     virtual void clearInfections( Treatments::Stages stage );
@@ -63,11 +63,12 @@ protected:
     // Doesn't do anything in this model:
     virtual void treatPkPd(size_t schedule, size_t dosages, double age, double delay_d);
     
-    /** The list of all infections this human has.
+    /** The list of all infections this human has, in order of creation
+     * (the order matters for random number usage).
      * 
      * Since infection models and within host models are very much intertwined,
      * the idea is that each WithinHostModel has its own list of infections. */
-     std::list<DescriptiveInfection> infections;
+     std::vector<DescriptiveInfection> infections;
 
      bool opt_vaccine_genotype = false;
 };
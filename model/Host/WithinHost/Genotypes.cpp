@@ -35,6 +35,9 @@ namespace GT /*for genotype impl details*/{
 // ———  Model constants (after init)  ———
 // keys are cumulative probabilities; last entry should equal 1; values are genotype codes
 map<double,uint32_t> cum_initial_freqs;
+// flattened form of cum_initial_freqs used for sampling: keys and values
+Genotypes::CumulativeSampler initial_sampler;
+vector<uint32_t> initial_codes;
 
 // we give each allele of each loci a unique code
 map<string, map<string, uint32_t> > alleleCodes;
@@ -164,6 +167,16 @@ void Genotypes::init( const scnXml::Scenario& scenario ){
         GT::cum_initial_freqs[1.0] = GT::genotypes.size() - 1;
     }
     
+    vector<double> cum_keys;
+    cum_keys.reserve( GT::cum_initial_freqs.size() );
+    GT::initial_codes.clear();
+    GT::initial_codes.reserve( GT::cum_initial_freqs.size() );
+    for( auto it = GT::cum_initial_freqs.begin(); it != GT::cum_initial_freqs.end(); ++it ){
+        cum_keys.push_back( it->first );
+        GT::initial_codes.push_back( it->second );
+    }
+    GT::initial_sampler.prepare( cum_keys );
+    
     if( util::CommandLine::option( util::CommandLine::PRINT_GENOTYPES ) ){
         // reorganise GT::alleleCodes so that we can look up codes, not names
         vector<pair<string,string> > allele_codes( GT::cum_initial_freqs.size() );
@@ -275,16 +288,21 @@ const vector< Genotypes::Genotype >& Genotypes::getGenotypes(){
     return GT::genotypes;
 }
 
-uint32_t Genotypes::sampleGenotype( LocalRng& rng, vector<double>& genotype_weights ){
+// Equivalent to cum_initial_freqs.upper_bound( sample )->second
+inline uint32_t sampleInitial( LocalRng& rng ){
+    double sample = rng.uniform_01();
+    size_t i = GT::initial_sampler.upperBound( sample );
+    assert( i < GT::initial_codes.size() );
+    return GT::initial_codes[i];
+}
+
+uint32_t Genotypes::sampleGenotype( LocalRng& rng, const vector<double>& genotype_weights ){
     if( GT::current_mode == GT::SAMPLE_FIRST ){
         return 0;       // always the first genotype code
     }else if( GT::current_mode == GT::SAMPLE_INITIAL
             || genotype_weights.size() == 0 )
     {
-        double sample = rng.uniform_01();
-        auto it = GT::cum_initial_freqs.upper_bound( sample );
-        assert( it != GT::cum_initial_freqs.end() );
-        return it->second;
+        return sampleInitial( rng );
     }else{
         assert( GT::current_mode == GT::SAMPLE_TRACKING );
         assert( genotype_weights.size() == N_genotypes );
@@ -300,6 +318,58 @@ uint32_t Genotypes::sampleGenotype( LocalRng& rng, vector<double>& genotype_weig
     }
 }
 
+void Genotypes::CumulativeSampler::prepare( const vector<double>& cumulative ){
+    assert( cumulative.size() > 0 && cumulative.size() < numeric_limits<uint32_t>::max() );
+    cum.assign( cumulative.begin(), cumulative.end() );
+    // One guide entry per value: guide[j] is the first index whose cumulative
+    // weight exceeds j / scale, thus the search for x starts at guide[x*scale].
+    const size_t n = cum.size();
+    const double total = cum.back();
+    if( !(total > 0.0) ){
+        // all weights zero: any search starts from the beginning
+        scale = 0.0;
+        guide.assign( n, 0 );
+        return;
+    }
+    scale = n / total;
+    guide.resize( n );
+    size_t i = 0;
+    for( size_t j = 0; j < n; ++j ){
+        const double x = j / scale;
+        while( i < n && cum[i] <= x ) ++i;
+        guide[j] = static_cast<uint32_t>( i );
+    }
+}
+
+void Genotypes::Sampler::prepare( const vector<double>& genotype_weights ){
+    useWeights = GT::current_mode == GT::SAMPLE_TRACKING && genotype_weights.size() > 0;
+    if( !useWeights ) return;
+    assert( genotype_weights.size() == N_genotypes );
+    // same order of summation as util::vectors::sum, thus the total is identical
+    cumBuffer.resize( genotype_weights.size() );
+    double cum = 0.0;
+    for( size_t g = 0; g < genotype_weights.size(); ++g ){
+        cum += genotype_weights[g];
+        cumBuffer[g] = cum;
+    }
+    weights.prepare( cumBuffer );
+}
+
+uint32_t Genotypes::Sampler::sample( LocalRng& rng ) const{
+    if( GT::current_mode == GT::SAMPLE_FIRST ){
+        return 0;
+    }else if( !useWeights ){
+        return sampleInitial( rng );
+    }else{
+        const double weight_sum = weights.total();
+        assert( weight_sum >= 0.0 && weight_sum < 1e5 );        // possible loss of precision or other error
+        double sample = rng.uniform_01() * weight_sum;
+        size_t g = weights.upperBound( sample );
+        // as in sampleGenotype: fall back to 0 (could happen if weight_sum == 0.0)
+        return g < N_genotypes ? static_cast<uint32_t>(g) : 0;
+    }
+}
+
 double Genotypes::initialFreq( size_t genotype ){
     if( GT::genotypes.size() == 0 ){
         assert( genotype == 0 );
@@ -75,7 +75,60 @@ public:
      *  weights of each genotype for use in sampling. Total need not be one.
      *  Also, passing a zero-length vector is a signal to use initial
      *  frequencies in sampling. */
-    static uint32_t sampleGenotype( LocalRng& rng, std::vector<double>& genotype_weights );
+    static uint32_t sampleGenotype( LocalRng& rng, const std::vector<double>& genotype_weights );
+    
+    /** Inverse-CDF sampler over a list of increasing cumulative weights,
+     * using a guide table (Chen & Asau) to find the start of the search.
+     * 
+     * A draw costs O(1) expected time, yet returns exactly the same index as
+     * a linear scan for the first cumulative weight greater than the sample.
+     * The object may be reused; prepare() does not reallocate unless the
+     * number of entries grows. */
+    class CumulativeSampler {
+    public:
+        /// Prepare from cumulative weights (increasing; last is the total).
+        void prepare( const std::vector<double>& cumulative );
+        
+        /** Return the first index i with cumulative[i] > x, or the
+         * number of entries if there is none. Requires x >= 0. */
+        inline size_t upperBound( double x ) const{
+            size_t j = static_cast<size_t>( x * scale );
+            if( j >= guide.size() ) j = guide.size() - 1;
+            size_t i = guide[j];
+            // the guide entry is a lower bound except for rounding errors:
+            while( i > 0 && cum[i-1] > x ) --i;
+            while( i < cum.size() && cum[i] <= x ) ++i;
+            return i;
+        }
+        
+        /// Total weight (last cumulative weight)
+        inline double total() const{ return cum.back(); }
+        
+    private:
+        std::vector<double> cum;
+        std::vector<uint32_t> guide;
+        double scale = 0.0;     // guide.size() / total
+    };
+    
+    /** Sampler for several genotypes drawn from the same weights, for example
+     * all new infections of one host in one step.
+     * 
+     * Results are identical to calling sampleGenotype() with the same weights
+     * for each draw, but the weights are only summed once (in prepare()) and
+     * each draw takes O(1) expected time. */
+    class Sampler {
+    public:
+        /// Prepare for sampling; genotype_weights as for sampleGenotype().
+        void prepare( const std::vector<double>& genotype_weights );
+        
+        /// Sample a genotype (uses one random number).
+        uint32_t sample( LocalRng& rng ) const;
+        
+    private:
+        bool useWeights = false;
+        CumulativeSampler weights;
+        std::vector<double> cumBuffer;
+    };
     
     /** Get the number of genotypes. Functions like sampleGenotype use values
      * from 0 to one less than this. */
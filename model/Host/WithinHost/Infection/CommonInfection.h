@@ -24,6 +24,8 @@
 
 #include "Host/WithinHost/Infection/Infection.h"
 #include "util/random.h"
+#include <limits>
+#include <vector>
 
 namespace OM { namespace WithinHost {
 
@@ -67,7 +69,15 @@ public:
 	    return updateDensity( rng, survivalFactor, bsAge, body_mass );
     }
     
-    map<size_t, double> Kn; // IC50^slope per drug type, if sampled
+    /// IC50^slope for the drug type with this index, or NaN if not yet sampled
+    inline double getKn( size_t index ) const{
+        return index < Kn.size() ? Kn[index] : std::numeric_limits<double>::quiet_NaN();
+    }
+    /// Store IC50^slope for the drug type with this index
+    inline void setKn( size_t index, double value ){
+        if( index >= Kn.size() ) Kn.resize( index + 1, std::numeric_limits<double>::quiet_NaN() );
+        Kn[index] = value;
+    }
     
 protected:
     /** Update: calculate new density.
@@ -82,6 +92,14 @@ protected:
     virtual bool updateDensity( LocalRng& rng, double survivalFactor, SimTime bsAge, double body_mass ) =0;
     
     virtual void checkpoint (ostream& stream);
+    
+private:
+    /** IC50^slope per drug type index (LSTMDrugType::getIndex()), NaN where
+     * not yet sampled. Empty until the infection first meets a drug.
+     * 
+     * Note: not checkpointed (it never was); values are resampled after
+     * loading a checkpoint. */
+    std::vector<double> Kn;
 };
 
 } }
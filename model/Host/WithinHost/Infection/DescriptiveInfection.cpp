@@ -103,11 +103,11 @@ void DescriptiveInfection::init (const Parameters& parameters) {
                 .append(densities_filename), Error::InputResource );
         }
 
-        //fill initial matrix
-        meanLogParasiteCount[i-1][j-1]=meanlogdens;
+        //fill initial matrix (by duration, then age; negative values are never used)
+        meanLogParasiteCount[j-1][i-1]=max(meanlogdens, 0.0);
         //fill also the triangle that will not be used (to ensure everything is initialised)
         if (j!=i) {
-            meanLogParasiteCount[j-1][i-1]=0.0;
+            meanLogParasiteCount[i-1][j-1]=0.0;
         }
 
     }
@@ -119,11 +119,17 @@ void DescriptiveInfection::init (const Parameters& parameters) {
 DescriptiveInfection::DescriptiveInfection (LocalRng& rng, uint32_t genotype, int origin) :
 	Infection(genotype, origin),
         m_duration(infectionDuration(rng)),
-        notPrintedMDWarning(true)
+        notPrintedMDWarning(true),
+        m_trajectory(trajectory(m_duration))
 {
     assert( sim::oneTS() == 5 );
 }
 
+const double* DescriptiveInfection::trajectory( SimTime duration ){
+    int32_t infDur = min( sim::inSteps(duration), maxDurationTS );
+    return meanLogParasiteCount[infDur];
+}
+
 SimTime DescriptiveInfection::infectionDuration(LocalRng& rng) {
     // Forgive the excess precision; it just avoids having to update all expected results
     double dur_mean = 5.1300001144409179688;
@@ -143,7 +149,7 @@ SimTime DescriptiveInfection::infectionDuration(LocalRng& rng) {
 // ———  time-step updates  ———
 void DescriptiveInfection::determineDensities(
         LocalRng& rng,
-        double cumulativeh,
+        double stdlog,
         double &timeStepMaxDensity,
         double immSurvFact,
         double innateImmSurvFact,
@@ -159,17 +165,13 @@ void DescriptiveInfection::determineDensities(
         timeStepMaxDensity = 0.0;
         
         int32_t infAge = min( sim::inSteps(infage), maxDurationTS );
-        int32_t infDur = min( sim::inSteps(m_duration), maxDurationTS );
-        m_density=max (meanLogParasiteCount[infAge][infDur], 0.0);
+        m_density = m_trajectory[infAge];
         
         // The expected parasite density in the non naive host (AJTM p.9 eq. 9)
         // Note that in published and current implementations Dx is zero.
         m_density = m_density * immSurvFact;
         
-        //Perturb m_density using a lognormal
-        double varlog = sigma0sq / (1.0 + (cumulativeh / xNuStar));
-        double stdlog = sqrt(varlog);
-        
+        //Perturb m_density using a lognormal (stdlog: see densityStdLog)
         /*
         This code samples from a log normal distribution with mean equal to the predicted density
         n.b. AJTM p.9 eq 9 implies that we sample the log of the density from a normal with mean equal to
@@ -215,6 +217,7 @@ DescriptiveInfection::DescriptiveInfection (istream& stream) :
 {
     m_duration & stream;
     notPrintedMDWarning & stream;
+    m_trajectory = trajectory(m_duration);
 }
 void DescriptiveInfection::checkpoint (ostream& stream) {
     Infection::checkpoint (stream);
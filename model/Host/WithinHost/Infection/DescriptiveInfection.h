@@ -24,6 +24,7 @@
 
 #include "Host/WithinHost/Infection/Infection.h"
 #include "util/random.h"
+#include <cmath>
 
 namespace OM { namespace WithinHost {
 
@@ -78,12 +79,20 @@ public:
         return sim::ts0() > m_startDate + m_duration;
     }
     
+    /** Standard deviation of the log of density, used to perturb the
+     * density of all infections of a host (AJTM p.9 eq. 13).
+     * 
+     * @param cumulativeh Cumulative number of infections
+     */
+    static inline double densityStdLog( double cumulativeh ){
+        double varlog = sigma0sq / (1.0 + (cumulativeh / xNuStar));
+        return sqrt(varlog);
+    }
+    
     /** Determines parasite density of an individual infection (5-day time step
      * update)
      *
-     * @param ageInYears Age (of human)
-     * @param cumulativeh Cumulative number of infections
-     * @param cumulativeY Previous exposure (cumulative parasite density)
+     * @param stdlog Result of densityStdLog() for this host
      * @param timeStepMaxDensity (In-out param) Used to return the maximum
      *  parasite density over a 5-day interval.
      * @param innateImmSurvFact Density multiplier for innate immunity.
@@ -91,7 +100,7 @@ public:
      */
     void determineDensities(
             LocalRng& rng,
-            double cumulativeh,
+            double stdlog,
             double &timeStepMaxDensity,
             double immSurvFact,
             double innateImmSurvFact,
@@ -119,11 +128,19 @@ protected:
     bool notPrintedMDWarning;
     
 private:
+    /* Expected density trajectory of this infection: the row of
+     * meanLogParasiteCount for its duration (set from m_duration). */
+    const double* m_trajectory;
+    
+    static const double* trajectory( SimTime duration );
+    
     /// @brief Static parameters set by init()
     //@{
-    /* A triangular matrix: meanLogParasiteCount[i][j] is the
+    /* A triangular matrix: meanLogParasiteCount[j][i] is the
      * Mean Log Parasite Count for age i (in time steps) of an infection which
-     * lasts j days. Indices with i>j are unused. */
+     * lasts j time steps, clamped to be non-negative. Indices with i>j are
+     * unused. Rows are by duration such that an infection walks along a
+     * single row as it ages. */
     static double meanLogParasiteCount[numDurations][numDurations];
     
     /// Sigma0^2 from AJTM p.9 eq. 13
@@ -47,16 +47,13 @@ double EmpiricalInfection::_mu2;
 double EmpiricalInfection::_mu3;
 double EmpiricalInfection::_sigma0_res;	
 double EmpiricalInfection::_sigmat_res;
-double EmpiricalInfection::_mu_beta1[_maximumDurationInDays];
-double EmpiricalInfection::_sigma_beta1[_maximumDurationInDays];
-double EmpiricalInfection::_mu_beta2[_maximumDurationInDays];
-double EmpiricalInfection::_sigma_beta2[_maximumDurationInDays];
-double EmpiricalInfection::_mu_beta3[_maximumDurationInDays];
-double EmpiricalInfection::_sigma_beta3[_maximumDurationInDays];
+EmpiricalInfection::DayParams EmpiricalInfection::_dayParams[_maximumDurationInDays];
 double EmpiricalInfection::_inflationMean;
 double EmpiricalInfection::_inflationVariance;
 double EmpiricalInfection::_extinctionLevel;
 double EmpiricalInfection::_overallMultiplier;
+double EmpiricalInfection::_logInflationMean;
+double EmpiricalInfection::_sqrtInflationVariance;
 
 
 CommonInfection* createEmpiricalInfection (LocalRng& rng, uint32_t protID, int origin) {
@@ -122,14 +119,24 @@ void EmpiricalInfection::init(){
     csvNum1 >> day;
     if (day < 0 || day >= _maximumDurationInDays)
       throw TRACED_EXCEPTION_DEFAULT ("EmpiricalInfection::init(): invalid day");
-    csvNum2 >> _mu_beta1[day];
-    csvNum3 >> _sigma_beta1[day];
-    csvNum4 >> _mu_beta2[day];
-    csvNum5 >> _sigma_beta2[day];
-    csvNum6 >> _mu_beta3[day];
-    csvNum7 >> _sigma_beta3[day];
+    DayParams& params = _dayParams[day];
+    csvNum2 >> params.mu_beta1;
+    csvNum3 >> params.sigma_beta1;
+    csvNum4 >> params.mu_beta2;
+    csvNum5 >> params.sigma_beta2;
+    csvNum6 >> params.mu_beta3;
+    csvNum7 >> params.sigma_beta3;
   }  
   f_autoRegressionParameters.close();
+  
+  for( int day = 0; day < _maximumDurationInDays; ++day )
+    _dayParams[day].sigma_noise = sigma_noise(day);
+  updateDerivedParams();
+}
+
+void EmpiricalInfection::updateDerivedParams(){
+  _logInflationMean = log(_inflationMean);
+  _sqrtInflationVariance = sqrt(_inflationVariance);
 }
 
 
@@ -167,31 +174,46 @@ bool EmpiricalInfection::updateDensity( LocalRng& rng, double survivalFactor, Si
   if (bsAge >= _maximumDurationInDays || !(L[0] > -999999.9))	// Note: second test is extremely unlikely to fail
     return true;	// cut-off point
   
+  const size_t ageDays = bsAge;
+  const DayParams& params = _dayParams[ageDays];
+  
+  // Terms which do not change between samples: the lagged density
+  // components of the linear predictor and the growth rate multiplier.
+  const double expL1 = exp(L[1]);
+  const double sumL = L[0]+L[1]+L[2];
+  const double diffL = L[2]-L[0];
+  const double curvatureL = L[2]+L[0]-2*L[1];
+  const double logGrowthRateMultiplier = log(_patentGrowthRateMultiplier);
+  
   // constraints to ensure the density is defined and not exploding
-  double upperLimitoflogDensity=log(_maximumPermittedAmplificationPerCycle*exp(L[1])/_inflationMean);
-  double amplificationPerCycle;
+  const double upperLimitoflogDensity=log(_maximumPermittedAmplificationPerCycle*expL1/_inflationMean);
+  const double maxDensity = _maximumPermittedAmplificationPerCycle*expL1;
+  
+  // Rejection sampling: nearly always the first sample is accepted, so the
+  // loops below are expected to run once (and their branches predicted as
+  // such). Random numbers are drawn in the same order as ever.
   double localDensity;	// density before scaling by _overallMultiplier
-  size_t ageDays = bsAge;
-  for(int tries0 = 0; tries0 < EI_MAX_SAMPLES; ++tries0) {
+  bool accepted = false;
+  for(int tries0 = 0; tries0 < EI_MAX_SAMPLES && !accepted; ++tries0) {
     double logDensity;
-    for(int tries1 = 0; tries1 < EI_MAX_SAMPLES; ++tries1) {
-      double b_1=rng.gauss(_mu_beta1[ageDays],_sigma_beta1[ageDays]);
-      double b_2=rng.gauss(_mu_beta2[ageDays],_sigma_beta2[ageDays]);
-      double b_3=rng.gauss(_mu_beta3[ageDays],_sigma_beta3[ageDays]);
-      double expectedlogDensity = b_1 * (L[0]+L[1]+L[2]) / 3
-      + b_2 * (L[2]-L[0]) / 2
-      + b_3 * (L[2]+L[0]-2*L[1]) / 4;
+    bool acceptedLog = false;
+    for(int tries1 = 0; tries1 < EI_MAX_SAMPLES && !acceptedLog; ++tries1) {
+      double b_1=rng.gauss(params.mu_beta1,params.sigma_beta1);
+      double b_2=rng.gauss(params.mu_beta2,params.sigma_beta2);
+      double b_3=rng.gauss(params.mu_beta3,params.sigma_beta3);
+      double expectedlogDensity = b_1 * sumL / 3
+      + b_2 * diffL / 2
+      + b_3 * curvatureL / 4;
       
       //include sampling error
-      logDensity=rng.gauss(expectedlogDensity,sigma_noise(ageDays));
+      logDensity=rng.gauss(expectedlogDensity,params.sigma_noise);
       //include drug and immunity effects via growthRateMultiplier 
-      logDensity += log(_patentGrowthRateMultiplier);
+      logDensity += logGrowthRateMultiplier;
       
-      if (logDensity <= upperLimitoflogDensity)	//got an acceptable density, we're done
-	break;	// most of the time this should happen first try
+      acceptedLog = logDensity <= upperLimitoflogDensity;
     }
-    if (!(logDensity <= upperLimitoflogDensity))	// in case all the above attempts fail, cap logDensity
-      logDensity=upperLimitoflogDensity;
+    // in case all the above attempts fail, cap logDensity (also catches NaN)
+    if (!acceptedLog) logDensity=upperLimitoflogDensity;
     
     localDensity= getInflatedDensity(rng, logDensity);
     
@@ -202,12 +224,11 @@ bool EmpiricalInfection::updateDensity( LocalRng& rng, double survivalFactor, Si
         localDensity=0.0;
     }
     
-    amplificationPerCycle=localDensity/exp(L[1]);
-    if (localDensity >= 0.0 && amplificationPerCycle <= _maximumPermittedAmplificationPerCycle)
-      break;	// We're done. Hopefully usually with the first try.
+    double amplificationPerCycle=localDensity/expL1;
+    accepted = localDensity >= 0.0 && amplificationPerCycle <= _maximumPermittedAmplificationPerCycle;
   }
-  if (!(localDensity >= 0.0 && amplificationPerCycle <= _maximumPermittedAmplificationPerCycle))	// in case the above tries fail
-    localDensity = _maximumPermittedAmplificationPerCycle*exp(L[1]);
+  if (!accepted)	// in case the above tries fail
+    localDensity = maxDensity;
   
   _laggedLogDensities[2]=_laggedLogDensities[1];
   _laggedLogDensities[1]=_laggedLogDensities[0];
@@ -253,7 +274,7 @@ double EmpiricalInfection::sigma_noise(int ageDays) {
 }
 
 double EmpiricalInfection::getInflatedDensity(LocalRng& rng, double nonInflatedDensity){
-  double inflatedLogDensity = log(_inflationMean) + rng.gauss(nonInflatedDensity, sqrt(_inflationVariance));
+  double inflatedLogDensity = _logInflationMean + rng.gauss(nonInflatedDensity, _sqrtInflationVariance);
   return exp(inflatedLogDensity);
 }
 
@@ -263,6 +284,7 @@ void EmpiricalInfection::overrideInflationFactors(double inflationMean, double i
   _extinctionLevel=extinctionLevel;
   _overallMultiplier=overallMultiplier;
   _subPatentLimit=10.0/_overallMultiplier;
+  updateDerivedParams();
 }
 
 
@@ -61,7 +61,7 @@ protected:
     
 private:
   double getInflatedDensity(LocalRng& rng, double nonInflatedDensity);
-  double sigma_noise(int ageDays);
+  static double sigma_noise(int ageDays);
   double samplePatentValue(LocalRng& rng, double mu, double sigma, double lowerBound);
   double sampleSubPatentValue(LocalRng& rng, double mu, double sigma, double upperBound);
   
@@ -82,17 +82,27 @@ private:
   static double _mu3;
   static double _sigma0_res;	
   static double _sigmat_res;
-  static double _mu_beta1[_maximumDurationInDays];
-  static double _sigma_beta1[_maximumDurationInDays];
-  static double _mu_beta2[_maximumDurationInDays];
-  static double _sigma_beta2[_maximumDurationInDays];
-  static double _mu_beta3[_maximumDurationInDays];
-  static double _sigma_beta3[_maximumDurationInDays];
+  /** Parameters of the autoregressive model for one day of blood-stage
+   * age, packed together since all are used for each update. */
+  struct DayParams {
+    double mu_beta1, sigma_beta1;
+    double mu_beta2, sigma_beta2;
+    double mu_beta3, sigma_beta3;
+    double sigma_noise;         ///< sigma_noise(day)
+  };
+  static DayParams _dayParams[_maximumDurationInDays];
   static double _inflationMean;
   static double _inflationVariance;
   static double _extinctionLevel;
   static double _overallMultiplier;
   //@}
+  
+  ///@brief Derived from the above by updateDerivedParams()
+  //@{
+  static double _logInflationMean;
+  static double _sqrtInflationVariance;
+  //@}
+  static void updateDerivedParams();
 };
 
 } }
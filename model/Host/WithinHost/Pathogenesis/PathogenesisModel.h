@@ -34,6 +34,7 @@ namespace scnXml{
 
 namespace OM {
     namespace Host { class Human; }
+    namespace mon { class HostSummary; }
     namespace WithinHost { namespace Pathogenesis {
 
 using util::LocalRng;
@@ -69,7 +70,7 @@ public:
      *
      * Only PyrogenPathogenesis implements this; other models don't have anything
      * to add to the summary. */
-    virtual void summarize (const Host::Human& human) {}
+    virtual void summarize (mon::HostSummary& summary) {}
 
     /// Checkpointing
     template<class S>
@@ -91,9 +91,9 @@ double PyrogenPathogenesis::getPEpisode(double timeStepMaxDensity, double totalD
     return timeStepMaxDensity / (timeStepMaxDensity + _pyrogenThres);
 }
 
-void PyrogenPathogenesis::summarize (const Host::Human& human) {
-    mon::reportStatMHF( mon::MHF_PYROGENIC_THRESHOLD, human, _pyrogenThres );
-    mon::reportStatMHF( mon::MHF_LOG_PYROGENIC_THRESHOLD, human, log(_pyrogenThres+1.0) );
+void PyrogenPathogenesis::summarize (mon::HostSummary& summary) {
+    summary.reportF( mon::MHF_PYROGENIC_THRESHOLD, _pyrogenThres );
+    summary.reportF( mon::MHF_LOG_PYROGENIC_THRESHOLD, log(_pyrogenThres+1.0) );
 }
 
 void PyrogenPathogenesis::updatePyrogenThres(double totalDensity){
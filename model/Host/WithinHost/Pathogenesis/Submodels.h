@@ -53,7 +53,7 @@ protected:
 public:
     PyrogenPathogenesis(double cF);
     virtual ~PyrogenPathogenesis() {}
-    virtual void summarize (const Host::Human& human);
+    virtual void summarize (mon::HostSummary& summary);
     virtual double getPEpisode(double timeStepMaxDensity, double totalDensity);
     
     /// Read parameters from XML
@@ -43,6 +43,12 @@ namespace OM {
 namespace Host {
     class Human;
 }
+namespace mon {
+    class HostSummary;
+}
+namespace PkPd {
+    class DecayBatch;
+}
 namespace WithinHost {
 
 using util::LocalRng;
@@ -116,8 +122,12 @@ public:
      * for local infections _l */
     virtual double probTransmissionToMosquito(vector<double> &probTransGenotype_i, vector<double> &probTransGenotype_l)const = 0;
 
-    /// @returns true if host has patent parasites
-    virtual bool summarize(Host::Human& human) const =0;
+    /** Report survey data to summary (the human's rng may be used).
+     * 
+     * Not const: drug decay deferred by the PK/PD model is applied here.
+     * 
+     * @returns true if host has patent parasites */
+    virtual bool summarize(Host::Human& human, mon::HostSummary& summary) =0;
 
     /// Create a new infection within this human
     virtual void importInfection(LocalRng& rng, int origin) =0;
@@ -148,6 +158,10 @@ public:
      * @param age Age of human in years
      */
     virtual void treatPkPd(size_t schedule, size_t dosages, double age, double delay_d) =0;
+    
+    /** Add the host's drugs, if modelled, to a batch whose deferred decay is
+     * applied together (see PkPd::DecayBatch). */
+    virtual void addToDecayBatch( PkPd::DecayBatch& batch ) {}
 
     /** Add new infections and update the parasite densities of existing
      * infections. Also update immune status.
@@ -159,7 +173,7 @@ public:
      * @param bsvFactor Parasite survival factor for blood-stage vaccines
      */
     virtual void update(Host::Human &human, LocalRng& rng, int &nNewInfs_i, int &nNewInfs_l, 
-        vector<double>& genotype_weights_i, vector<double>& genotype_weights_l, double ageInYears) =0;
+        const vector<double>& genotype_weights_i, const vector<double>& genotype_weights_l, double ageInYears) =0;
 
     /** TODO: this should not need to be exposed. It is currently used by a
      * severe outcome (pDeath) model inside the EventScheduler "case
@@ -34,6 +34,7 @@
 #include "util/sampler.h"
 #include <schema/scenario.h>
 #include <algorithm>
+#include <functional>
 #include <limits>
 #include <cmath>
 
@@ -107,7 +108,7 @@ double effectivenessPQ = numeric_limits<double>::signaling_NaN();
 
 #ifdef WHVivaxSamples
 WHVivax *sampleHost = 0;
-VivaxBrood *sampleBrood = 0;
+uint32_t sampleBrood = numeric_limits<uint32_t>::max();
 #endif
 
 
@@ -154,50 +155,33 @@ SimTime sampleReleaseDelay(LocalRng& rng){
 
 // ———  per-brood code  ———
 
-VivaxBrood::VivaxBrood( LocalRng& rng, int origin, WHVivax *host ) :
+VivaxBrood::VivaxBrood( LocalRng& rng, int origin, uint32_t id, vector<SimTime>& releases ) :
+        id( id ),
         primaryHasStarted( false ),
         relapseHasStarted( false ),
         hadEvent( false ),
         hadRelapse( false ),
         origin(origin)
 {
-    set<SimTime> releases;     // used to initialise releaseDates; a set is better to use now but a vector later
+    releases.clear();
     
     // primary blood stage plus hypnozoites (relapses)
-    releases.insert( sim::nowOrTs0() + latentP );
+    releases.push_back( sim::nowOrTs0() + latentP );
     int numberHypnozoites = sampleNHypnozoites(rng);
     for( int i = 0; i < numberHypnozoites; ){
         //TODO: why do we have two latent periods (latentP + latentReleaseDays added in sampleReleaseDelay())?
         SimTime randomReleaseDelay = sampleReleaseDelay(rng);
         SimTime timeToRelease = sim::nowOrTs0() + latentP + randomReleaseDelay;
-        bool inserted = releases.insert( timeToRelease ).second;
-        if( inserted ) ++i;     // successful
+        if( std::find( releases.begin(), releases.end(), timeToRelease ) == releases.end() ){
+            releases.push_back( timeToRelease );
+            ++i;     // successful
+        }
         // else: sample clash with an existing release date, so resample
     }
-    
-    // Copy times to the vector, backwards (smallest last):
-    releaseDates.insert( releaseDates.end(), releases.rbegin(), releases.rend() );
-    
-#ifdef WHVivaxSamples
-    if( sampleHost == host && sampleBrood == 0 ){
-        sampleBrood = this;
-        cout << "New sample brood";
-        for( auto it = releaseDates.begin(); it != releaseDates.end(); ++it )
-            cout << '\t' << *it;
-        cout << endl;
-    }
-#endif
-}
-VivaxBrood::~VivaxBrood(){
-#ifdef WHVivaxSamples
-    if( sampleBrood == this ){
-        sampleBrood = 0;
-        cout << "Brood terminated" << endl;
-    }
-#endif
+    pendingReleases = releases.size();
 }
 
-void VivaxBrood::checkpoint( ostream& stream ){
+void VivaxBrood::checkpoint( ostream& stream, vector<SimTime>& releaseDates ){
     releaseDates & stream;
     bloodStageClearDate & stream;
     primaryHasStarted & stream;
@@ -206,8 +190,11 @@ void VivaxBrood::checkpoint( ostream& stream ){
     hadRelapse & stream;
     origin & stream;
 }
-VivaxBrood::VivaxBrood( istream& stream ){
+VivaxBrood::VivaxBrood( istream& stream, uint32_t id, vector<SimTime>& releaseDates ) :
+        id( id )
+{
     releaseDates & stream;
+    pendingReleases = releaseDates.size();
     bloodStageClearDate & stream;
     primaryHasStarted & stream;
     relapseHasStarted & stream;
@@ -217,7 +204,7 @@ VivaxBrood::VivaxBrood( istream& stream ){
 }
 
 
-VivaxBrood::UpdResult VivaxBrood::update(LocalRng& rng){
+VivaxBrood::UpdResult VivaxBrood::update(LocalRng& rng, bool releaseDue){
     if( bloodStageClearDate == sim::ts0() ){
         //NOTE: this effectively means that both asexual and sexual stage
         // parasites self-terminate. It also means the immune system can
@@ -225,40 +212,39 @@ VivaxBrood::UpdResult VivaxBrood::update(LocalRng& rng){
     }
     
     UpdResult result;
-    while( releaseDates.size() > 0 && releaseDates.back() == sim::ts0() ){
-        releaseDates.pop_back();
+    // Release dates of a brood are distinct, thus at most one is due now.
+    // If pendingReleases is zero, the liver stage was cleared by treatment.
+    if( releaseDue && pendingReleases > 0 ){
+        pendingReleases -= 1;
         
 #ifdef WHVivaxSamples
-        if( sampleBrood == this ){
-            cout << "Time\t" << sim::ts0();
-            for( auto it = releaseDates.begin(); it != releaseDates.end(); ++it )
-                cout << '\t' << *it;
-            cout << endl;
+        if( sampleBrood == id ){
+            cout << "Time\t" << sim::ts0() << "\tpending\t" << pendingReleases << endl;
         }
 #endif
         
         // an existing or recently terminated blood stage from the same brood
         // protects against a newly released Hypnozoite
         //NOTE: this is an immunity effect: should there be no immunity when a blood stage first emerges?
-        if( bloodStageClearDate + bloodStageProtectionLatency >= sim::ts0() ) continue;
-        
-        if( !relapseHasStarted && primaryHasStarted ){
-            relapseHasStarted = true;
-            result.newRelapseBS = true;
-        }
-        if( !primaryHasStarted ){
-            primaryHasStarted = true;
-            result.newPrimaryBS = true;
+        if( !(bloodStageClearDate + bloodStageProtectionLatency >= sim::ts0()) ){
+            if( !relapseHasStarted && primaryHasStarted ){
+                relapseHasStarted = true;
+                result.newRelapseBS = true;
+            }
+            if( !primaryHasStarted ){
+                primaryHasStarted = true;
+                result.newPrimaryBS = true;
+            }
+            result.newBS = true;
+            
+            double lengthDays = bloodStageLength.sample(rng);
+            bloodStageClearDate = sim::ts0() + sim::roundToTSFromDays( lengthDays );
+            // Assume gametocytes emerge at the same time (they mature quickly and
+            // we have little data, thus assume coincedence of start)
         }
-        result.newBS = true;
-        
-        double lengthDays = bloodStageLength.sample(rng);
-        bloodStageClearDate = sim::ts0() + sim::roundToTSFromDays( lengthDays );
-        // Assume gametocytes emerge at the same time (they mature quickly and
-        // we have little data, thus assume coincedence of start)
     }
     
-    result.isFinished = (!isPatent()) && (releaseDates.size() == 0);
+    result.isFinished = isFinished();
     return result;
 }
 
@@ -270,18 +256,11 @@ void VivaxBrood::treatmentBS(){
 }
 
 void VivaxBrood::treatmentLS(){
-    releaseDates.clear();       // 100% clearance
+    // 100% clearance; queued release events of this brood become stale
+    pendingReleases = 0;
     
-    /* partial clearance code, in case of need:
-    vector<SimTime> survivingZoites;
-    survivingZoites.reserve( releaseDates.size() );   // maximum size we need
-    for( auto it = releaseDates.begin(); it != releaseDates.end(); ++it ){
-        if( !rng.bernoulli( pClearEachHypnozoite ) ){
-            survivingZoites.push_back( *it );    // copy            
-        }
-    }
-    swap( releaseDates, survivingZoites );
-    */
+    /* partial clearance would require removing individual events from the
+     * host's queue (or recording which of the queued events survive). */
 }
 
 
@@ -310,6 +289,7 @@ WHVivax::~WHVivax(){
 #ifdef WHVivaxSamples
     if( this == sampleHost ){
         sampleHost = 0;
+        sampleBrood = numeric_limits<uint32_t>::max();
         cout << "Host terminates" << endl;
     }
 #endif
@@ -327,39 +307,65 @@ double WHVivax::probTransmissionToMosquito(vector<double> &probTransGenotype_i,
     return 0;   // no gametocytes
 }
 
-bool WHVivax::summarize(Host::Human& human) const{
+bool WHVivax::summarize(Host::Human& human, mon::HostSummary& summary){
     if( infections.size() == 0 ) return false;  // no infections: not patent, nothing to report
-    mon::reportStatMHI( mon::MHR_INFECTED_HOSTS, human, 1 );
+    summary.reportI( mon::MHR_INFECTED_HOSTS, 1 );
     bool patentHost = false;
     // (patent) infections are reported by genotype, even though we don't have
     // genotype in this model
-    mon::reportStatMHGI( mon::MHR_INFECTIONS, human, 0, infections.size() );
+    summary.reportGI( mon::MHR_INFECTIONS, 0, infections.size() );
     for(auto inf = infections.begin(); inf != infections.end(); ++inf) {
         if (inf->isPatent()){
-            mon::reportStatMHGI( mon::MHR_PATENT_INFECTIONS, human, 0, 1 );
+            summary.reportGI( mon::MHR_PATENT_INFECTIONS, 0, 1 );
             patentHost = true;
         }
     }
-    if( patentHost ) mon::reportStatMHI( mon::MHR_PATENT_HOSTS, human, 1 );
+    if( patentHost ) summary.reportI( mon::MHR_PATENT_HOSTS, 1 );
     return patentHost;
 }
 
+void WHVivax::scheduleEvent( SimTime date, uint32_t brood, bool isRelease ){
+    events.push_back( BroodEvent{ date, brood, isRelease } );
+    push_heap( events.begin(), events.end(), greater<BroodEvent>() );
+}
+
+void WHVivax::addBrood( LocalRng& rng, int origin ){
+    static thread_local vector<SimTime> releases;
+    uint32_t id = nextBroodId++;
+    infections.push_back( VivaxBrood( rng, origin, id, releases ) );
+    for( SimTime date : releases ) scheduleEvent( date, id, true );
+    
+#ifdef WHVivaxSamples
+    if( sampleHost == this && sampleBrood == numeric_limits<uint32_t>::max() ){
+        sampleBrood = id;
+        cout << "New sample brood";
+        for( auto it = releases.begin(); it != releases.end(); ++it )
+            cout << '\t' << *it;
+        cout << endl;
+    }
+#endif
+}
+
 void WHVivax::importInfection(LocalRng& rng, int origin){
     // this means one new liver stage infection, which can result in multiple blood stages
-    infections.push_back( VivaxBrood( rng, origin, this ) );
+    addBrood( rng, origin );
+}
+
+inline bool broodIdLess( const VivaxBrood& brood, uint32_t id ){
+    return brood.getId() < id;
 }
 
 void WHVivax::update(Host::Human &human, LocalRng& rng, int &nNewInfs_i, int &nNewInfs_l, 
-        vector<double>& genotype_weights_i, vector<double>& genotype_weights_l, double ageInYears)
+        const vector<double>& genotype_weights_i, const vector<double>& genotype_weights_l, double ageInYears)
 {
     pSevere = 0.0;
     
     // create new infections, letting the constructor do the initialisation work:
     for( int i = 0; i < nNewInfs_i; ++i )
-        infections.push_back( VivaxBrood( rng, InfectionOrigin::Introduced, this ) );
+        addBrood( rng, InfectionOrigin::Introduced );
 
     for( int i = 0; i < nNewInfs_l; ++i )
-        infections.push_back( VivaxBrood( rng, InfectionOrigin::Indigenous, this ) );
+        addBrood( rng, InfectionOrigin::Indigenous );
     
     // update infections
     // NOTE: currently no BSV model
@@ -370,14 +376,46 @@ void WHVivax::update(Host::Human &human, LocalRng& rng, int &nNewInfs_i, int &nN
     double oldpEvent = ( std::isnan(pEvent))? 1.0 : pEvent;
     // always use the first relapse probability for following relapses as a factor
     double oldpRelapseEvent = ( std::isnan(pFirstRelapseEvent))? 1.0 : pFirstRelapseEvent;
-    auto inf = infections.begin();
-    while( inf != infections.end() ){
-        if( treatmentLiver ) inf->treatmentLS();
-        if( treatmentBlood ) inf->treatmentBS();        // clearnace due to treatment; no protection against reemergence
-        VivaxBrood::UpdResult result = inf->update(rng);
+    
+    if( treatmentLiver || treatmentBlood ){
+        for( VivaxBrood& brood : infections ){
+            if( treatmentLiver ) brood.treatmentLS();
+            if( treatmentBlood ) brood.treatmentBS();        // clearnace due to treatment; no protection against reemergence
+        }
+        checkFinished = true;
+    }
+    
+    // Take all events due now from the queue. Broods without events have
+    // nothing to do (no random numbers are used), so we only visit these
+    // broods, in order of creation (as the random number stream requires).
+    static thread_local vector<BroodEvent> dueEvents;
+    dueEvents.clear();
+    while( !events.empty() && events.front().date <= sim::ts0() ){
+        assert( !events.front().isRelease || events.front().date == sim::ts0() );
+        pop_heap( events.begin(), events.end(), greater<BroodEvent>() );
+        dueEvents.push_back( events.back() );
+        events.pop_back();
+    }
+    // order by brood, then releases first
+    sort( dueEvents.begin(), dueEvents.end(), []( const BroodEvent& a, const BroodEvent& b ){
+        return a.brood < b.brood || (a.brood == b.brood && a.isRelease > b.isRelease);
+    } );
+    
+    for( auto ev = dueEvents.begin(); ev != dueEvents.end(); ){
+        const uint32_t id = ev->brood;
+        const bool releaseDue = ev->isRelease;
+        while( ev != dueEvents.end() && ev->brood == id ) ++ev;     // skip remaining events of this brood
+        
+        auto inf = lower_bound( infections.begin(), infections.end(), id, broodIdLess );
+        if( inf == infections.end() || inf->getId() != id ) continue;     // brood already finished
+        
+        VivaxBrood::UpdResult result = inf->update(rng, releaseDue);
         if( result.newPrimaryBS ) cumPrimInf += 1;
         
         if( result.newBS ){
+            if( inf->getBloodStageClearDate() > sim::ts0() )
+                scheduleEvent( inf->getBloodStageClearDate(), id, false );
+            
             // Sample for each new blood stage infection: the chance of some
             // clinical event.
             
@@ -414,8 +452,14 @@ void WHVivax::update(Host::Human &human, LocalRng& rng, int &nNewInfs_i, int &nN
             }
         }
         
-        if( result.isFinished ) inf = infections.erase( inf );
-        else ++inf;
+        if( result.isFinished ) checkFinished = true;
+    }
+    
+    if( checkFinished ){
+        // remove finished broods, preserving order
+        infections.erase( remove_if( infections.begin(), infections.end(),
+            []( const VivaxBrood& brood ){ return brood.isFinished(); } ), infections.end() );
+        checkFinished = false;
     }
     
     //TODO were pEvent and pFirstRelapseEvent meant to get updated?
@@ -465,6 +509,7 @@ void WHVivax::optionalPqTreatment( Host::Human& human ){
             for( auto it = infections.begin(); it != infections.end(); ++it ){
                 it->treatmentLS();
             }
+            checkFinished = true;
         }
         mon::reportEventMHI( mon::MHT_LS_TREATMENTS, human, 1 );
     }
@@ -488,6 +533,7 @@ bool WHVivax::treatSimple( Host::Human& human, SimTime timeLiver, SimTime timeBl
                 for( auto it = infections.begin(); it != infections.end(); ++it ){
                     it->treatmentLS();
                 }
+                checkFinished = true;
             }
         }
         mon::reportEventMHI( mon::MHT_LS_TREATMENTS, human, 1 );
@@ -500,6 +546,7 @@ bool WHVivax::treatSimple( Host::Human& human, SimTime timeLiver, SimTime timeBl
             for( auto it = infections.begin(); it != infections.end(); ++it ){
                 it->treatmentBS();
             }
+            checkFinished = true;
         }else{
             treatExpiryBlood = max( int(treatExpiryBlood), sim::nowOrTs1() + timeBlood );
         }
@@ -515,9 +562,17 @@ void WHVivax::checkpoint(istream& stream){
     WHInterface::checkpoint(stream);
     size_t len;
     len & stream;
+    infections.reserve( len );
+    vector<SimTime> releaseDates;
     for( size_t i = 0; i < len; ++i ){
-        infections.push_back( VivaxBrood( stream ) );
+        uint32_t id = nextBroodId++;
+        infections.push_back( VivaxBrood( stream, id, releaseDates ) );
+        for( SimTime date : releaseDates ) scheduleEvent( date, id, true );
+        if( infections.back().getBloodStageClearDate() != sim::never() )
+            scheduleEvent( infections.back().getBloodStageClearDate(), id, false );
     }
+    // broods which finished after treatment are removed on the next update:
+    checkFinished = true;
     noPQ & stream;
     int morbidity_i;
     morbidity_i & stream;
@@ -531,8 +586,20 @@ void WHVivax::checkpoint(istream& stream){
 void WHVivax::checkpoint(ostream& stream){
     WHInterface::checkpoint(stream);
     infections.size() & stream;
-    for( auto it = infections.begin(); it != infections.end(); ++it ){
-        it->checkpoint( stream );
+    // collect pending release dates of each brood from the event queue
+    vector<vector<SimTime>> releaseDates( infections.size() );
+    for( const BroodEvent& ev : events ){
+        if( !ev.isRelease ) continue;
+        auto inf = lower_bound( infections.begin(), infections.end(), ev.brood, broodIdLess );
+        if( inf == infections.end() || inf->getId() != ev.brood ) continue;
+        if( inf->getPendingReleases() == 0 ) continue;      // stale after treatment
+        releaseDates[inf - infections.begin()].push_back( ev.date );
+    }
+    for( size_t i = 0; i < infections.size(); ++i ){
+        vector<SimTime>& dates = releaseDates[i];
+        assert( dates.size() == infections[i].getPendingReleases() );
+        sort( dates.begin(), dates.end(), greater<SimTime>() );     // soonest last
+        infections[i].checkpoint( stream, dates );
     }
     noPQ & stream;
     static_cast<int>( morbidity ) & stream;
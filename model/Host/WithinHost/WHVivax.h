@@ -25,7 +25,7 @@
 #include "Global.h"
 #include "Host/WithinHost/WHInterface.h"
 
-#include <list>
+#include <vector>
 #include <memory>
 
 using namespace std;
@@ -41,7 +41,6 @@ namespace Pathogenesis {
     class PathogenesisModel;
 }
 
-class WHVivax;
 /**
  * A brood is the set of hypnozoites resulting from an innoculation, plus an
  * associated blood stage.
@@ -50,34 +49,48 @@ class WHVivax;
  * initiated by another hypnozoite from the same brood is active, the newly
  * released hypnozoite does nothing, however, blood stage infections from other
  * broods have no effect.
+ * 
+ * Release dates are not stored here but in the host's event queue (see
+ * WHVivax::events); the brood only counts its pending releases.
  */
 class VivaxBrood{
 public:
     /** Create.
      * 
-     * @param host      The host creating this. Not really needed, except to
-     * prevent VivaxBrood being default-constructed by its container.
+     * @param id        Identifier, unique within the host and increasing in
+     *  order of creation.
+     * @param releases  Output: the dates at which the merozoite and
+     *  hypnozoites release (the brood's pending releases). Previous content
+     *  is discarded.
      */
-    VivaxBrood( LocalRng& rng, int origin, WHVivax *host );
-    ~VivaxBrood();
-    /** Save a checkpoint. */
-    void checkpoint( ostream& stream );
-    /** Create from checkpoint. */
-    VivaxBrood( istream& stream );
+    VivaxBrood( LocalRng& rng, int origin, uint32_t id, vector<SimTime>& releases );
+    /** Save a checkpoint.
+     * 
+     * @param releaseDates Dates of pending releases, soonest last. */
+    void checkpoint( ostream& stream, vector<SimTime>& releaseDates );
+    /** Create from checkpoint.
+     * 
+     * @param releaseDates Output: dates of pending releases */
+    VivaxBrood( istream& stream, uint32_t id, vector<SimTime>& releaseDates );
     
     struct UpdResult{
         UpdResult() : newPrimaryBS(false), newRelapseBS(false), newBS(false) {}
         bool newPrimaryBS, newRelapseBS, newBS, isFinished;
     };
     /**
-     * Do per time step update: remove finished blood stage infections and act
-     * on newly releasing hypnozoites.
+     * Do per time step update: act on a newly releasing hypnozoite.
      * 
+     * @param releaseDue True if the host's event queue has a release of this
+     *  brood due now. Ignored if the liver stage has since been cleared.
      * @return pair describing whether the infection is finished (no more blood
      *  or liver stages) and whether a new primary blood-stage has started (to
      *  update cumPrimInf)
      */
-    UpdResult update(LocalRng& rng);
+    UpdResult update(LocalRng& rng, bool releaseDue);
+    
+    inline uint32_t getId()const{ return id; }
+    inline uint32_t getPendingReleases()const{ return pendingReleases; }
+    inline SimTime getBloodStageClearDate()const{ return bloodStageClearDate; }
     
     inline void setHadEvent( bool hadEvent ){ this->hadEvent = hadEvent; }
     inline bool hasHadEvent()const{ return hadEvent; }
@@ -91,6 +104,11 @@ public:
         return bloodStageClearDate > sim::latestTs0();
     }
     
+    /// True when there are no more blood or liver stages
+    inline bool isFinished() const{
+        return !isPatent() && pendingReleases == 0;
+    }
+    
     /** Fully clear blood stage parasites. */
     void treatmentBS();
     
@@ -100,9 +118,10 @@ public:
 private:
     VivaxBrood() {}     // not default constructible
     
-    // list of times at which the merozoite and hypnozoites release, ordered by
-    // time of release, soonest last (i.e. last element is next one to release)
-    vector<SimTime> releaseDates;
+    uint32_t id;
+    
+    // Number of merozoite and hypnozoite releases still to come
+    uint32_t pendingReleases = 0;
     
     // Either sim::never() (no blood stage) or the start of the time step on
     // which the blood stage will clear.
@@ -152,12 +171,12 @@ public:
     
     virtual double probTransmissionToMosquito(vector<double> &probTransGenotype_i, vector<double> &probTransGenotype_l)const;
     
-    virtual bool summarize(Host::Human& human) const;
+    virtual bool summarize(Host::Human& human, mon::HostSummary& summary);
     
     virtual void importInfection(LocalRng& rng, int origin);
     
     virtual void update(Host::Human &human, LocalRng& rng, int &nNewInfs_i, int &nNewInfs_l, 
-        vector<double>& genotype_weights_i, vector<double>& genotype_weights_l, double ageInYears);
+        const vector<double>& genotype_weights_i, const vector<double>& genotype_weights_l, double ageInYears);
     
     virtual bool diagnosticResult( LocalRng& rng, const Diagnostic& diagnostic ) const;
 
@@ -188,7 +207,37 @@ private:
     WHVivax( const WHVivax& ) = delete;
     WHVivax& operator= (const WHVivax& ) = delete;
     
-    list<VivaxBrood> infections;
+    /// Create a new brood (liver-stage infection)
+    void addBrood( LocalRng& rng, int origin );
+    
+    /// Add an event to the queue
+    void scheduleEvent( SimTime date, uint32_t brood, bool isRelease );
+    
+    /** An upcoming event of one brood: the release of a hypnozoite (or the
+     * primary merozoite), or the clearance of a blood stage (when the brood
+     * may finish). */
+    struct BroodEvent{
+        SimTime date;
+        uint32_t brood;     // brood id
+        bool isRelease;
+        // ordering for a min-heap on date
+        inline bool operator>( const BroodEvent& that )const{ return date > that.date; }
+    };
+    
+    /// All broods, ordered by id (i.e. by order of creation)
+    vector<VivaxBrood> infections;
+    
+    /** Min-heap (on date) of upcoming brood events. Entries may be stale (e.g.
+     * after liver-stage treatment or when a blood stage is extended); acting
+     * on a stale entry has no effect. Not checkpointed: rebuilt from broods. */
+    vector<BroodEvent> events;
+    
+    // Id of the next brood to be created
+    uint32_t nextBroodId = 0;
+    
+    // Set when a brood may have finished outside of event processing (i.e.
+    // after treatment), requiring a scan for finished broods.
+    bool checkFinished = false;
     
     /* Is flagged as never getting PQ: this is a heteogeneity factor. Example:
      * Set to zero if everyone can get PQ, 0.5 if females can't get PQ and
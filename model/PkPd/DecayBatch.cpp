@@ -0,0 +1,92 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2022 University of Basel
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "PkPd/DecayBatch.h"
+#include "PkPd/LSTMModel.h"
+#include "PkPd/Drug/LSTMDrugOneComp.h"
+
+#include <algorithm>
+
+namespace OM { namespace PkPd {
+
+void DecayBatch::add( LSTMModel& model ){
+    if( !model.pendingDecay.empty() ) models.push_back( &model );
+}
+
+bool DecayBatch::less( const Entry& a, const Entry& b ){
+    const size_t ia = a.drug->getIndex(), ib = b.drug->getIndex();
+    if( ia != ib ) return ia < ib;
+    
+    const vector<DecayRun>& ra = *a.runs;
+    const vector<DecayRun>& rb = *b.runs;
+    if( ra.size() != rb.size() ) return ra.size() < rb.size();
+    for( size_t r = 0; r < ra.size(); ++r ){
+        if( ra[r].days != rb[r].days ) return ra[r].days < rb[r].days;
+    }
+    
+    const auto& da = a.drug->doses;
+    const auto& db = b.drug->doses;
+    if( da.size() != db.size() ) return da.size() < db.size();
+    for( size_t d = 0; d < da.size(); ++d ){
+        if( da[d].first != db[d].first ) return da[d].first < db[d].first;
+    }
+    return false;
+}
+
+void DecayBatch::apply(){
+    for( LSTMModel* model : models ){
+        for( auto& drug : model->m_drugs ){
+            LSTMDrugOneComp* oneComp = dynamic_cast<LSTMDrugOneComp*>( drug.get() );
+            if( oneComp != nullptr ){
+                if( oneComp->isActive() )
+                    entries.push_back( Entry{ oneComp, &model->pendingDecay } );
+            }else{
+                drug->decay( model->pendingDecay );
+            }
+        }
+    }
+    
+    sort( entries.begin(), entries.end(), less );
+    for( auto first = entries.begin(); first != entries.end(); ){
+        auto last = first + 1;
+        while( last != entries.end() && !less( *first, *last ) ) ++last;
+        groupDrugs.clear();
+        groupRuns.clear();
+        for( auto it = first; it != last; ++it ){
+            groupDrugs.push_back( it->drug );
+            groupRuns.push_back( it->runs );
+        }
+        LSTMDrugOneComp::decayGroup( groupDrugs.size(), groupDrugs.data(), groupRuns.data() );
+        first = last;
+    }
+    
+    for( LSTMModel* model : models ){
+        model->drugsActive = false;
+        for( auto& drug : model->m_drugs ){
+            model->drugsActive = model->drugsActive || drug->isActive();
+        }
+        model->pendingDecay.clear();
+    }
+    models.clear();
+    entries.clear();
+}
+
+} }
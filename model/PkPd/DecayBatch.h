@@ -0,0 +1,66 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2022 University of Basel
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef Hmod_PkPd_DecayBatch
+#define Hmod_PkPd_DecayBatch
+
+#include "Global.h"
+#include "PkPd/Drug/LSTMDrug.h"
+
+namespace OM {
+namespace PkPd {
+
+class LSTMModel;
+class LSTMDrugOneComp;
+
+/** Applies deferred drug decay (see LSTMModel::decayDrugs()) to many hosts
+ * together.
+ *
+ * After mass drug administration, many hosts carry the same drug type with
+ * the same dose times and decay runs. One-compartment drugs of such hosts
+ * are grouped, and each group is decayed by LSTMDrugOneComp::decayGroup(),
+ * which evaluates the group's exponentials in one pass over contiguous
+ * arrays. Other drugs are decayed individually. Results are identical to
+ * applying decay per host. */
+class DecayBatch {
+public:
+    /// Add a host's drugs. Decay is applied by apply().
+    void add( LSTMModel& model );
+    
+    /// Apply decay to all hosts added since the last call.
+    void apply();
+    
+private:
+    struct Entry {
+        LSTMDrugOneComp* drug;
+        const vector<DecayRun>* runs;
+    };
+    /// Order by drug type, days of each decay run, then dose times
+    static bool less( const Entry& a, const Entry& b );
+    
+    vector<LSTMModel*> models;
+    vector<Entry> entries;
+    vector<LSTMDrugOneComp*> groupDrugs;
+    vector<const vector<DecayRun>*> groupRuns;
+};
+
+} }
+#endif
@@ -53,6 +53,7 @@ void LSTMDrug::medicate(double time, double qty){
     auto pos = lower_bound(doses.begin(), doses.end(), elt, comp);
     doses.insert(pos, move(elt));
     assert(is_sorted(doses.begin(), doses.end(), comp));
+    revision += 1;
 }
 
 }
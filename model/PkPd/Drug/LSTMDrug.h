@@ -34,6 +34,12 @@ namespace PkPd {
 
 using util::LocalRng;
 
+/// A number of days of deferred decay at one body mass (see LSTMDrug::decay())
+struct DecayRun {
+    double body_mass;
+    uint32_t days;
+};
+
 /** A class holding pkpd drug use info.
  *
  * Each human has an instance for each type of drug present in their blood. */
@@ -78,11 +84,27 @@ public:
      */
     virtual double calculateDrugFactor(LocalRng& rng, WithinHost::CommonInfection *inf, double body_mass) const =0;
     
+    /** True while the drug has any effect: some concentration in the body
+     * or doses pending. When false, calculateDrugFactor() returns 1 and
+     * updateConcentration() does nothing. */
+    virtual bool isActive() const =0;
+    
     /** Updates concentration variable and clears day's doses.
      * 
      * @param body_mass Weight of patient in kg */
     virtual void updateConcentration (double body_mass) =0;
     
+    /** Equivalent to calling updateConcentration(run.body_mass) run.days
+     * times for each run in order (used when decay has been deferred over
+     * several days). */
+    virtual void decay (const vector<DecayRun>& runs){
+        for( const DecayRun& run : runs ){
+            for( uint32_t days = run.days; days > 0 && isActive(); --days ){
+                updateConcentration( run.body_mass );
+            }
+        }
+    }
+    
     /// Checkpointing
     template<class S>
     void operator& (S& stream) {
@@ -105,6 +127,11 @@ protected:
     
     /// Volume of distribution, sampled when this class is first created.
     double vol_dist;
+    
+    /** Incremented whenever doses or concentrations change, such that derived
+     * classes can tell when cached values computed from these are stale. Not
+     * checkpointed. */
+    uint32_t revision = 0;
 };
 
 }
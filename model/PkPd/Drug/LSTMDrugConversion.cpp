@@ -24,8 +24,8 @@
 #include "util/errors.h"
 #include "util/StreamValidator.h"
 #include "util/vectors.h"
+#include "util/integration.h"
 
-#include <gsl/gsl_integration.h>
 #include <limits>
 
 using namespace std;
@@ -129,26 +129,23 @@ double func_convFactor( double t, void* pp ){
     return max(fCP,fCM);
 }
 
-const size_t GSL_INTG_CONV_MAX_ITER = 1000;     // 10 seems enough, but no harm in using a higher value
-gsl_integration_workspace *gsl_intgr_conv_wksp = gsl_integration_workspace_alloc (GSL_INTG_CONV_MAX_ITER);
-//NOTE: we "should" free, but mem-leaks at end of program aren't really important
-// gsl_integration_workspace_free (gsl_intgr_conv_wksp);
 double LSTMDrugConversion::calculateFactor(const Params_convFactor& p, double duration) const{
-    gsl_function F;
-    F.function = &func_convFactor;
-    // gsl_function doesn't accept const; we re-apply const later
-    F.params = static_cast<void*>(const_cast<Params_convFactor*>(&p));
+    if( p.qtyG == 0.0 && p.qtyP == 0.0 && p.qtyM == 0.0 ){
+        return 1.0;     // no drug over this interval: the integral is zero
+    }
+    auto fC = [&p]( double t ){ return func_convFactor( t, static_cast<void*>(const_cast<Params_convFactor*>(&p)) ); };
     
     // We use exp(-result), so small absolute differences can matter (but also
     // using smaller abs_eps is cheap). We likely don't need high rel precision.
     const double abs_eps = 1e-5, rel_eps = 1e-2;
-    // NOTE: 1 through 6 are different algorithms of increasing complexity
-    const int qag_rule = 1;     // alg 1 seems to be good enough
     double intfC, err_eps;      // intfC will carry our result; err_eps is a measure of accuracy of the result
     
 //     intg_steps = 0;
-    int r = gsl_integration_qag (&F, 0.0, duration, abs_eps, rel_eps,
-                                 GSL_INTG_CONV_MAX_ITER, qag_rule, gsl_intgr_conv_wksp, &intfC, &err_eps);
+    // Same result as gsl_integration_qag with rule 1 (15-point Gauss-Kronrod).
+    // Not replaced by integrate_gl5 with OM_FAST_PKPD: the integrand (the max
+    // of two Hill functions) has kinks, where results differed from QAG by
+    // up to 0.5%.
+    int r = util::integrate_qag15( fC, 0.0, duration, abs_eps, rel_eps, intfC, err_eps );
     if( r != 0 ){
         throw TRACED_EXCEPTION( "calculateFactor: error from gsl_integration_qag",util::Error::GSL );
     }
@@ -164,10 +161,11 @@ void LSTMDrugConversion::setConversionParameters(Params_convFactor& p,
     p.qtyG = qtyG; p.qtyP = qtyP; p.qtyM = qtyM;
     
     // decay "constants" (dependent on body mass):
-    const double nkP = nkP_sample * pow(body_mass, parentType.neg_m_exponent());      // -y
-    const double nconv = nconv_sample * pow(body_mass, parentType.neg_m_exponent());  // -z
+    updateMassRates( body_mass );
+    const double nkP = rateNkP;      // -y
+    const double nconv = rateNconv;  // -z
     p.nka = nka;        // -x
-    p.nkM = nkM_sample * pow(body_mass, metaboliteType.neg_m_exponent());  // -k
+    p.nkM = rateNkM;  // -k
     p.nl = nkP + nconv;    // -(y + z)
     
     p.f = nka / (p.nl - nka);                           // -x / (x-y-z) = x / (y+z-x)
@@ -194,28 +192,26 @@ void LSTMDrugConversion::setKillingParameters(LocalRng& rng, Params_convFactor&
     
     // Use custom code here because we need to handle covariance
     auto pIndex = parentType.getIndex();
-    if (inf->Kn.count(pIndex) != 0) {
+    p.KnP = inf->getKn(pIndex);
+    if( !std::isnan(p.KnP) ){
         // Read cached values: IC50 ^ n
-        p.KnP = inf->Kn.at(pIndex);
-        p.KnM = inf->Kn.at(metaboliteType.getIndex());
+        p.KnM = inf->getKn(metaboliteType.getIndex());
     } else {
         // First usage for this infection / treatment: sample, optionally with correlation.
         auto zscore = NormalSample::generate(rng);
         p.KnP = pdP.IC50_pow_slope(zscore);
-        inf->Kn[pIndex] = p.KnP;
+        inf->setKn(pIndex, p.KnP);
         
         auto metab_zscore = parentType.IC50_correlated_sample(zscore, rng);
         p.KnM = pdM.IC50_pow_slope(metab_zscore);
-        inf->Kn[metaboliteType.getIndex()] = p.KnM;
+        inf->setKn(metaboliteType.getIndex(), p.KnM);
     }
 }
 
 // TODO: in high transmission, is this going to get called more often than updateConcentration?
 // When does it make sense to try to optimise (avoid doing decay calcuations here)?
 double LSTMDrugConversion::calculateDrugFactor(LocalRng& rng, WithinHost::CommonInfection *inf, double body_mass) const {
-    if( qtyG == 0.0 && qtyP == 0.0 && qtyM == 0.0 && doses.size() == 0 ){
-        return 1.0; // nothing to do
-    }
+    if( !isActive() ) return 1.0; // nothing to do
     
     Params_convFactor p;
     setConversionParameters(p, body_mass);
@@ -251,9 +247,7 @@ double LSTMDrugConversion::calculateDrugFactor(LocalRng& rng, WithinHost::Common
 }
 
 void LSTMDrugConversion::updateConcentration( double body_mass ){
-    if( qtyG == 0.0 && qtyP == 0.0 && qtyM == 0.0 && doses.size() == 0 ){
-        return; // nothing to do
-    }
+    if( !isActive() ) return; // nothing to do
     last_bm = body_mass;
     
     Params_convFactor p;
@@ -25,6 +25,7 @@
 #include "Global.h"
 #include "PkPd/Drug/LSTMDrug.h"
 #include "PkPd/Drug/LSTMDrugType.h"
+#include <limits>
 
 using namespace std;
 
@@ -52,6 +53,9 @@ public:
     virtual double getConcentration(size_t index) const;
     
     virtual double calculateDrugFactor(LocalRng& rng, WithinHost::CommonInfection *inf, double body_mass) const;
+    virtual bool isActive() const{
+        return qtyG != 0.0 || qtyP != 0.0 || qtyM != 0.0 || doses.size() != 0;
+    }
     virtual void updateConcentration (double body_mass);
     double getMetaboliteConcentration() const;
     double getParentConcentration() const;
@@ -87,6 +91,22 @@ protected:
     //@}
     
 private:
+    /// Update the mass-scaled rate constants below, if body mass has changed
+    inline void updateMassRates( double body_mass ) const{
+        if( rateBodyMass == body_mass ) return;
+        const double parentMassFactor = pow(body_mass, parentType.neg_m_exponent());
+        rateNkP = nkP_sample * parentMassFactor;
+        rateNconv = nconv_sample * parentMassFactor;
+        rateNkM = nkM_sample * pow(body_mass, metaboliteType.neg_m_exponent());
+        rateBodyMass = body_mass;
+    }
+    
+    /// @brief Rate constants scaled for body mass rateBodyMass (not checkpointed)
+    //@{
+    mutable double rateBodyMass = numeric_limits<double>::quiet_NaN();
+    mutable double rateNkP = 0.0, rateNconv = 0.0, rateNkM = 0.0;
+    //@}
+    
     void setConversionParameters(Params_convFactor& p, double body_mass) const;
     void setKillingParameters(LocalRng& rng, Params_convFactor& p, WithinHost::CommonInfection *inf) const;
 };
@@ -46,22 +46,15 @@ double LSTMDrugOneComp::getConcentration(size_t index) const {
     else return 0.0;
 }
 
-// TODO: in high transmission, is this going to get called more often than updateConcentration?
-// When does it make sense to try to optimise (avoid doing decay calcuations here)?
-double LSTMDrugOneComp::calculateDrugFactor(LocalRng& rng, WithinHost::CommonInfection *inf, double body_mass) const {
-    if( concentration == 0.0 && doses.size() == 0 ) return 1.0; // nothing to do
+void LSTMDrugOneComp::updateTrajectory( double body_mass ) const{
+    if( trajectoryRevision == revision && trajectoryBodyMass == body_mass ) return;
     
-    /* Survival factor of the parasite (this multiplies the parasite density).
-    Calculated below for each time interval. */
-    double totalFactor = 1.0;
+    trajectory.clear();
+    pdCached = nullptr;
     
-    // Make a copy of concetration and use that over today. Don't adjust concentration because this
-    // function may be called multiple times (or not at all) in a day.
+    // Walk over today's doses, as LSTMDrugPD::calcFactor would
     double concentration_today = concentration; // mg / l
-    double neg_elim_rate = neg_elim_sample * pow(body_mass, typeData.neg_m_exponent());
-    
-    const LSTMDrugPD& drugPD = typeData.getPD(inf->genotype());
-    const double Kn = drugPD.IC50_pow_slope(rng, typeData.getIndex(), inf);
+    double neg_elim_rate = negElimRate( body_mass );
     
     double time = 0.0;
     typedef pair<double,double> TimeConc;
@@ -69,7 +62,9 @@ double LSTMDrugOneComp::calculateDrugFactor(LocalRng& rng, WithinHost::CommonInf
         // we iteratate through doses in time order (since doses are sorted)
         if( time_conc.first < 1.0 /*i.e. today*/ ){
             if( time < time_conc.first ){
-                totalFactor *= drugPD.calcFactor( Kn, neg_elim_rate, &concentration_today, time_conc.first - time );
+                double C1 = concentration_today * exp(neg_elim_rate * (time_conc.first - time));
+                trajectory.push_back( Segment{ concentration_today, C1, 0.0, 0.0 } );
+                concentration_today = C1;
                 time = time_conc.first;
             }else{ assert( time == time_conc.first ); }
             // add dose (instantaneous absorption):
@@ -79,19 +74,54 @@ double LSTMDrugOneComp::calculateDrugFactor(LocalRng& rng, WithinHost::CommonInf
         }
     }
     if( time < 1.0 ){
-        totalFactor *= drugPD.calcFactor( Kn, neg_elim_rate, &concentration_today, 1.0 - time );
+        double C1 = concentration_today * exp(neg_elim_rate * (1.0 - time));
+        trajectory.push_back( Segment{ concentration_today, C1, 0.0, 0.0 } );
+    }
+    
+    trajectoryRevision = revision;
+    trajectoryBodyMass = body_mass;
+    trajectoryNegElimRate = neg_elim_rate;
+}
+
+void LSTMDrugOneComp::updateTrajectoryPD( const LSTMDrugPD& drugPD ) const{
+    if( pdCached == &drugPD ) return;
+    
+    const double n = drugPD.slope();
+    for( Segment& seg : trajectory ){
+        seg.C0n = hillPow(seg.C0, n);
+        seg.C1n = hillPow(seg.C1, n);
+    }
+    killingPower = drugPD.killingPower( trajectoryNegElimRate );
+    pdCached = &drugPD;
+}
+
+// The concentration trajectory is computed once per day (see
+// updateTrajectory); each infection then only needs its own Kn.
+double LSTMDrugOneComp::calculateDrugFactor(LocalRng& rng, WithinHost::CommonInfection *inf, double body_mass) const {
+    if( !isActive() ) return 1.0; // nothing to do
+    
+    const LSTMDrugPD& drugPD = typeData.getPD(inf->genotype());
+    const double Kn = drugPD.IC50_pow_slope(rng, typeData.getIndex(), inf);
+    
+    updateTrajectory( body_mass );
+    updateTrajectoryPD( drugPD );
+    
+    /* Survival factor of the parasite (this multiplies the parasite density).
+    Calculated for each time interval. */
+    double totalFactor = 1.0;
+    for( const Segment& seg : trajectory ){
+        totalFactor *= drugPD.calcFactor( Kn, seg.C0n, seg.C1n, killingPower );
     }
     
     return totalFactor; // Drug effect per day per drug per parasite
 }
 
 void LSTMDrugOneComp::updateConcentration( double body_mass ){
-    if( concentration == 0.0 && doses.size() == 0 ) return;     // nothing to do
+    if( !isActive() ) return;     // nothing to do
+    revision += 1;
     
     // exponential decay of drug concentration (portion without new doses):
-    //TODO: is it faster to pre-calculate this and either store an extra
-    // parameter or adapt uses of neg_elim_rate, etc. below?
-    double neg_elim_rate = neg_elim_sample * pow(body_mass, typeData.neg_m_exponent());
+    double neg_elim_rate = negElimRate( body_mass );
     concentration *= exp(neg_elim_rate);
     size_t doses_taken = 0;
     typedef pair<double,double> TimeConc;
@@ -125,5 +155,110 @@ void LSTMDrugOneComp::checkpoint(istream& stream){
     neg_elim_sample & stream;
 }
 
+void LSTMDrugOneComp::decay( const vector<DecayRun>& runs ){
+    // Doses are only added after decay is applied, thus days with doses (if
+    // any) come first; these are handled as usual. Without doses,
+    // updateConcentration only multiplies by exp(rate) each day, so we sum
+    // the exponent over the remaining days and apply it once.
+    double negExponent = 0.0;
+    for( const DecayRun& run : runs ){
+        uint32_t days = run.days;
+        for( ; days > 0 && doses.size() != 0; --days ){
+            updateConcentration( run.body_mass );
+        }
+        if( days > 0 && concentration != 0.0 ){
+            negExponent += negElimRate( run.body_mass ) * days;
+        }
+    }
+    if( negExponent == 0.0 ) return;
+    revision += 1;
+    
+    // Concentration only decreases, so checking the cut-off at the end is
+    // the same as checking it daily.
+    concentration *= exp( negExponent );
+    util::streamValidate( concentration );
+    if( concentration < typeData.getNegligibleConcentration() ){
+        concentration = 0.0;
+    }
+}
+
+void LSTMDrugOneComp::decayGroup( size_t n, LSTMDrugOneComp* const* drugs,
+        const vector<DecayRun>* const* runs )
+{
+    // This follows decay() and updateConcentration() for each host, step by
+    // step, using the same arithmetic.
+    thread_local vector<double> conc, rate, mass, negExponent, doseConc;
+    conc.resize( n );
+    rate.resize( n );
+    mass.resize( n );
+    doseConc.resize( n );
+    negExponent.assign( n, 0.0 );
+    for( size_t i = 0; i < n; ++i ) conc[i] = drugs[i]->concentration;
+    
+    // Dose times are shared by the group (thus are updated once), while
+    // quantities may differ.
+    thread_local vector<double> doseTimes;
+    doseTimes.clear();
+    for( const pair<double,double>& time_conc : drugs[0]->doses ){
+        doseTimes.push_back( time_conc.first );
+    }
+    size_t dosesTaken = 0;
+    const double negligible = drugs[0]->typeData.getNegligibleConcentration();
+    
+    const vector<DecayRun>& runs0 = *runs[0];
+    for( size_t r = 0; r < runs0.size(); ++r ){
+        uint32_t days = runs0[r].days;
+        for( size_t i = 0; i < n; ++i ){
+            mass[i] = (*runs[i])[r].body_mass;
+            rate[i] = drugs[i]->negElimRate( mass[i] );
+        }
+        
+        // Days with doses, as updateConcentration:
+        for( ; days > 0 && dosesTaken < doseTimes.size(); --days ){
+            for( size_t i = 0; i < n; ++i ) conc[i] *= exp( rate[i] );
+            size_t taken = 0;
+            for( size_t d = dosesTaken; d < doseTimes.size(); ++d ){
+                const double time = doseTimes[d];
+                if( time < 1.0 /*i.e. today*/ ){
+                    for( size_t i = 0; i < n; ++i ){
+                        doseConc[i] = drugs[i]->doses[d].second / (drugs[i]->vol_dist * mass[i]);
+                    }
+                    for( size_t i = 0; i < n; ++i ){
+                        conc[i] += doseConc[i] * exp( rate[i] * (1.0 - time) );
+                    }
+                    taken += 1;
+                }else /*i.e. tomorrow or later*/{
+                    doseTimes[d] -= 1.0;
+                }
+            }
+            dosesTaken += taken;
+            for( size_t i = 0; i < n; ++i ){
+                if( conc[i] < negligible ) conc[i] = 0.0;
+            }
+        }
+        
+        // Remaining days without doses, as decay():
+        if( days > 0 ){
+            for( size_t i = 0; i < n; ++i ){
+                if( conc[i] != 0.0 ) negExponent[i] += rate[i] * days;
+            }
+        }
+    }
+    for( size_t i = 0; i < n; ++i ){
+        if( negExponent[i] != 0.0 ) conc[i] *= exp( negExponent[i] );
+    }
+    
+    for( size_t i = 0; i < n; ++i ){
+        LSTMDrugOneComp& drug = *drugs[i];
+        drug.concentration = conc[i] < negligible ? 0.0 : conc[i];
+        util::streamValidate( drug.concentration );
+        drug.doses.erase( drug.doses.begin(), drug.doses.begin() + dosesTaken );
+        for( size_t d = 0; d < drug.doses.size(); ++d ){
+            drug.doses[d].first = doseTimes[dosesTaken + d];
+        }
+        drug.revision += 1;
+    }
+}
+
 }
 }
@@ -25,6 +25,8 @@
 #include "Global.h"
 #include "PkPd/Drug/LSTMDrug.h"
 #include "PkPd/Drug/LSTMDrugType.h"
+#include <limits>
+#include <vector>
 
 using namespace std;
 
@@ -32,6 +34,7 @@ namespace OM {
 
 namespace PkPd {
 struct DoseParams;
+class DecayBatch;
 }
 
 namespace PkPd {
@@ -50,7 +53,11 @@ public:
     virtual double getConcentration(size_t index) const;
     
     virtual double calculateDrugFactor(LocalRng& rng, WithinHost::CommonInfection *inf, double body_mass) const;
+    virtual bool isActive() const{
+        return concentration != 0.0 || doses.size() != 0;
+    }
     virtual void updateConcentration (double body_mass);
+    virtual void decay (const vector<DecayRun>& runs);
     
 protected:
     virtual void checkpoint (istream& stream);
@@ -65,6 +72,50 @@ protected:
     
     /// Sampled elimination rate constant
     double neg_elim_sample;
+    
+private:
+    /** Elimination rate constant scaled for body mass (negated). pow is only
+     * evaluated when body mass changes (at most once per time step). */
+    inline double negElimRate( double body_mass ) const{
+        if( rateBodyMass != body_mass ){
+            rateNegElim = neg_elim_sample * pow(body_mass, typeData.neg_m_exponent());
+            rateBodyMass = body_mass;
+        }
+        return rateNegElim;
+    }
+    
+    /** Apply deferred decay to n drugs of the same type whose hosts have the
+     * same number of days in each decay run and the same dose times (see
+     * DecayBatch). Results are identical to calling drugs[i]->decay(*runs[i])
+     * for each i. Per-host values are held in contiguous arrays, so the
+     * loops over hosts (including their exp calls) can be vectorised. */
+    static void decayGroup( size_t n, LSTMDrugOneComp* const* drugs,
+            const vector<DecayRun>* const* runs );
+    
+    /** Compute the concentration trajectory over today, unless already
+     * done since the last change of doses, concentration or body mass. */
+    void updateTrajectory( double body_mass ) const;
+    /// Compute pow(C, n) over the trajectory for this PD, if not already done.
+    void updateTrajectoryPD( const LSTMDrugPD& drugPD ) const;
+    
+    /** Concentration at the start and end of each period between doses
+     * today. Depends only on the host, and thus is shared by all infections.
+     * C0n and C1n are C0 and C1 raised to the power of the slope of pdCached. */
+    struct Segment {
+        double C0, C1;
+        double C0n, C1n;
+    };
+    mutable vector<Segment> trajectory;
+    mutable uint32_t trajectoryRevision = numeric_limits<uint32_t>::max();
+    mutable double trajectoryBodyMass = numeric_limits<double>::quiet_NaN();
+    mutable double trajectoryNegElimRate = 0.0;
+    mutable const LSTMDrugPD *pdCached = nullptr;
+    mutable double killingPower = 0.0;        // killingPower() of pdCached
+    
+    mutable double rateBodyMass = numeric_limits<double>::quiet_NaN();
+    mutable double rateNegElim = 0.0;         // negElimRate() for rateBodyMass
+    
+    friend class DecayBatch;
 };
 
 }
@@ -23,8 +23,8 @@
 #include "Host/WithinHost/Infection/CommonInfection.h"
 #include "util/errors.h"
 #include "util/StreamValidator.h"
+#include "util/integration.h"
 
-#include <gsl/gsl_integration.h>
 #include <limits>
 
 using namespace std;
@@ -123,24 +123,59 @@ double func_fC( double t, void* pp ){
     const double fC = p.V * cn / (cn + p.Kn);       // unitless
     return fC;
 }
-const size_t GSL_INTG_MAX_ITER = 1000;     // 10 seems enough, but no harm in using a higher value
-gsl_integration_workspace *gsl_intgr_wksp = gsl_integration_workspace_alloc (GSL_INTG_MAX_ITER);
-//NOTE: we "should" free, but mem-leaks at end of program aren't really important
-// gsl_integration_workspace_free (gsl_intgr_wksp);
+#ifdef OM_FAST_PKPD
+/** If one exponential term of the concentration dominates the others over
+ * [0, duration] (their sum is below 1e-9 of it, so the drug factor changes
+ * by less than slope * 1e-9 relative), set c0 and rate to that term and
+ * return true. All rates are negative (decay), so the others are largest at
+ * 0 and the dominant term is smallest at duration. */
+bool singleExponential( const Params_fC& p, double duration, double& c0, double& rate ){
+    const double coeffs[3] = { p.cA, p.cB, p.cC }, rates[3] = { p.na, p.nb, p.ng };
+    // the slowest-decaying term eventually dominates
+    int d = -1;
+    for( int i = 0; i < 3; ++i ){
+        if( coeffs[i] > 0.0 && (d < 0 || rates[i] > rates[d]) ) d = i;
+    }
+    if( d < 0 ) return false;
+    double others = fabs( p.cABC );
+    for( int i = 0; i < 3; ++i ){
+        if( i != d ) others += fabs( coeffs[i] );
+    }
+    if( others > 1e-9 * coeffs[d] * exp( rates[d] * duration ) ) return false;
+    c0 = coeffs[d];
+    rate = rates[d];
+    return true;
+}
+#endif
+
 double LSTMDrugThreeComp::calculateFactor(const Params_fC& p, double duration) const{
-    gsl_function F;
-    F.function = &func_fC;
-    // gsl_function doesn't accept const; we re-apply const later
-    F.params = static_cast<void*>(const_cast<Params_fC*>(&p));
+    if( p.cA == 0.0 && p.cB == 0.0 && p.cC == 0.0 && p.cABC == 0.0 ){
+        return 1.0;     // no drug over this interval: the integral is zero
+    }
+    auto fC = [&p]( double t ){ return func_fC( t, static_cast<void*>(const_cast<Params_fC*>(&p)) ); };
     
     // NOTE: tolerances are arbitrary, but seem to be sufficient
     const double abs_eps = 1e-2, rel_eps = 1e-2;
-    // NOTE: 1 through 6 are different algorithms of increasing complexity
-    const int qag_rule = 1;     // alg 1 seems to be good enough
     double intfC, err_eps;
     
-    int r = gsl_integration_qag (&F, 0.0, duration, abs_eps, rel_eps,
-                                 GSL_INTG_MAX_ITER, qag_rule, gsl_intgr_wksp, &intfC, &err_eps);
+#ifdef OM_FAST_PKPD
+    // Faster, within util::integration::GL_FACTOR_REL_TOL of the QAG result
+    double c0, rate;
+    if( singleExponential( p, duration, c0, rate ) ){
+        intfC = util::integrate_hill_exp( pow(c0, p.n), p.n * rate, p.V, p.Kn, duration );
+        return 1.0 / exp( intfC );
+    }
+    int r;
+    if( p.cABC <= 0.01 * (p.cA + p.cB + p.cC - p.cABC) ){
+        // Absorption nearly complete: the integrand is smooth
+        r = util::integrate_gl5( fC, 0.0, duration, 1e-8, 1e-6, intfC, err_eps );
+    }else{
+        r = util::integrate_qag15( fC, 0.0, duration, abs_eps, rel_eps, intfC, err_eps );
+    }
+#else
+    // Same result as gsl_integration_qag with rule 1 (15-point Gauss-Kronrod)
+    int r = util::integrate_qag15( fC, 0.0, duration, abs_eps, rel_eps, intfC, err_eps );
+#endif
     if( r != 0 ){
         throw TRACED_EXCEPTION( "calculateFactor: error from gsl_integration_qag",util::Error::GSL );
     }
@@ -157,7 +192,7 @@ double LSTMDrugThreeComp::calculateFactor(const Params_fC& p, double duration) c
 // TODO: in high transmission, is this going to get called more often than updateConcentration?
 // When does it make sense to try to optimise (avoid doing decay calcuations here)?
 double LSTMDrugThreeComp::calculateDrugFactor(LocalRng& rng, WithinHost::CommonInfection *inf, double body_mass) const {
-    if( conc() == 0.0 && doses.size() == 0 ) return 1.0; // nothing to do
+    if( !isActive() ) return 1.0; // nothing to do
     updateCached(body_mass);
     
     Params_fC p;
@@ -200,7 +235,7 @@ double LSTMDrugThreeComp::calculateDrugFactor(LocalRng& rng, WithinHost::CommonI
 }
 
 void LSTMDrugThreeComp::updateConcentration (double body_mass) {
-    if( conc() == 0.0 && doses.size() == 0 ) return;     // nothing to do
+    if( !isActive() ) return;     // nothing to do
     updateCached(body_mass);
     
     // exponential decay of existing quantities:
@@ -53,6 +53,9 @@ public:
     virtual double getConcentration(size_t index) const;
     
     virtual double calculateDrugFactor(LocalRng& rng, WithinHost::CommonInfection *inf, double body_mass) const;
+    virtual bool isActive() const{
+        return conc() != 0.0 || doses.size() != 0;
+    }
     virtual void updateConcentration (double body_mass);
     
 protected:
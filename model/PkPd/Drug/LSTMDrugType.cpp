@@ -61,21 +61,19 @@ double LSTMDrugPD::calcFactor( double Kn, double neg_elim_rate, double* conc, do
     // From Hastings & Winter 2011 paper
     // Note: these look a little different from original equations because Kn
     // is calculated when parameters are read from the scenario document instead of now.
-    const double numerator = Kn + pow(C1, n);
-    const double denominator = Kn + pow(C0, n);
+    const double numerator = Kn + hillPow(C1, n);
+    const double denominator = Kn + hillPow(C0, n);
     const double power = V / (-neg_elim_rate * n);
     
     *conc = C1;    // conc is an in/out parameter
-    return pow( numerator / denominator, power );       // unitless
+    return hillPow( numerator / denominator, power );       // unitless
 }
 
 double LSTMDrugPD::IC50_pow_slope(LocalRng& rng, size_t index, WithinHost::CommonInfection *inf) const{
-    double Kn;  // gets sampled once per infection
-    if (inf->Kn.count(index) != 0) {
-        Kn = inf->Kn.at(index);
-    } else {
+    double Kn = inf->getKn(index);     // gets sampled once per infection
+    if( std::isnan(Kn) ){
         Kn = pow(IC50.sample(rng), n);
-        inf->Kn[index] = Kn;
+        inf->setKn(index, Kn);
     }
     return Kn;
 }
@@ -24,6 +24,7 @@
 
 #include "Global.h"
 #include "util/sampler.h"
+#include "util/FastMath.h"
 
 #include <string>
 #include <deque>
@@ -52,6 +53,16 @@ using util::LocalRng;
 class LSTMDrugType;
 class LSTMDrug;
 
+/** pow as used for Hill-function drug factors: std::pow, or
+ * util::fastmath::pow when built with OM_FAST_PKPD. */
+inline double hillPow( double x, double y ){
+#ifdef OM_FAST_PKPD
+    return util::fastmath::pow( x, y );
+#else
+    return pow( x, y );
+#endif
+}
+
 /** Drug PD parameters (specified per phenotype), as well as applicable
  * functions to calculate drug factors and concentrations.
  * 
@@ -78,6 +89,18 @@ public:
      */
     double calcFactor( double Kn, double neg_elim_rate, double* C0, double duration ) const;
     
+    /** As calcFactor, but given the concentration at start and end of the
+     * period raised to the power slope() and the result of
+     * killingPower(neg_elim_rate). This allows the concentration trajectory
+     * to be shared by all infections. */
+    inline double calcFactor( double Kn, double C0n, double C1n, double power ) const{
+        return hillPow( (Kn + C1n) / (Kn + C0n), power );
+    }
+    /// Exponent used by calcFactor
+    inline double killingPower( double neg_elim_rate ) const{
+        return V / (-neg_elim_rate * n);
+    }
+    
     inline double slope() const{ return n; }
     double IC50_pow_slope(LocalRng& rng, size_t index, WithinHost::CommonInfection *inf) const;
     inline double IC50_pow_slope(NormalSample normal) const {
@@ -32,11 +32,9 @@
 #include "schema/pharmacology.h"
 
 #include <vector>
-#include <map>
 
 using std::size_t;
 using std::vector;
-using std::map;
 
 class UnittestUtil;
 namespace OM { namespace PkPd {
@@ -54,19 +52,25 @@ struct DosageTable {
      * 
      * Dosings may be given as a table using age or body mass as the key (first
      * column), or dose may be specified as mg drug / kg body mass. */
-    double getMultiplier( double key ){
+    double getMultiplier( double key ) const{
         if( multMassKg ) return key;
         else{
-            auto iter = table.upper_bound( key );
-            if( iter == table.end() )
+            // bounds is sorted and ends with infinity; this also rejects NaN
+            if( !(key < bounds.back()) )
                 throw TRACED_EXCEPTION( "bad age/dosage table", util::Error::PkPd );
-            return iter->second;
+            // Index of first bound greater than key (as upper_bound). Tables
+            // are short, so counting without branches is fastest.
+            size_t i = 0;
+            for( double bound : bounds ) i += (bound <= key);
+            return mults[i];
         }
     }
     
     bool useMass;       // false: dosing by age; true: dosing by body mass
     bool multMassKg;    // multiply by mass instead of using table
-    map<double,double> table;
+    /// Upper bounds (exclusive) of each age/mass group, increasing, and
+    /// multipliers for each group
+    vector<double> bounds, mults;
 };
 
 extern vector<Schedule> schedules;
@@ -30,7 +30,9 @@
 
 #include "schema/scenario.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 
 namespace OM { namespace PkPd {
 
@@ -58,64 +60,79 @@ void LSTMModel::checkpoint (istream& stream) {
         index & stream;
         m_drugs.push_back( LSTMDrugType::createInstance(rng, index) );
         m_drugs.back() & stream;
+        if( index >= drugSlots.size() ) drugSlots.resize( LSTMDrugType::numDrugTypes(), NO_SLOT );
+        drugSlots[index] = i;
+        drugsActive = drugsActive || m_drugs.back()->isActive();
     }
     medicateQueue & stream;
+    day = 0;
+    for( MedicateData& data : medicateQueue ) data.setDue( day );
 }
 
 void LSTMModel::checkpoint (ostream& stream) {
+    applyDecay();
     m_drugs.size() & stream;
     for( auto& drug : m_drugs ){
         drug->getIndex() & stream;
         drug & stream;
     }
-    medicateQueue & stream;
+    // Write times relative to the next day, as before (exact; see setDue):
+    medicateQueue.size() & stream;
+    for( MedicateData data : medicateQueue ){
+        data.time += static_cast<double>( data.dueDay - day );
+        data & stream;
+    }
 }
 
 
 // ———  non-static simulation time functions  ———
 
 void LSTMModel::prescribe(size_t schedule, size_t dosage, double age, double body_mass, double delay_d){
-    DosageTable& table = dosages[dosage];
+    const DosageTable& table = dosages[dosage];
     double key = table.useMass ? body_mass : age;
     double doseMult = table.getMultiplier( key );
-    for( MedicateData& medicateData : schedules[schedule].medications ){
+    const vector<MedicateData>& medications = schedules[schedule].medications;
+    for( const MedicateData& medicateData : medications ){
         MedicateData data = medicateData.multiplied(doseMult);
         data.time += delay_d;
-        medicateQueue.push_back( std::move(data) );
+        data.setDue( day );
+        // insert after all medications due the same day or earlier:
+        auto pos = upper_bound( medicateQueue.begin(), medicateQueue.end(), data.dueDay,
+            []( uint32_t dueDay, const MedicateData& x ){ return dueDay < x.dueDay; } );
+        medicateQueue.insert( pos, std::move(data) );
     }
 }
 
 void LSTMModel::medicate(LocalRng& rng){
     if( medicateQueue.empty() ) return;
     
-    // Process pending medications (in interal queue) and apply/update:
+    // Process pending medications due today (at the front of the queue):
     auto iter = medicateQueue.begin();
-    while( iter != medicateQueue.end() ){
-        if( iter->time < 1.0 ){   // Medicate medications to be prescribed starting at the next time-step
-            // This function could be inlined, except for uses in testing:
-            medicateDrug (rng, iter->drug, iter->qty, iter->time);
-            iter = medicateQueue.erase (iter);
-        }else{  // and decrement treatment seeking delay for the rest
-            iter->time -= 1.0;
-            ++iter;
-        }
+    while( iter != medicateQueue.end() && iter->dueDay <= day ){
+        // This function could be inlined, except for uses in testing:
+        medicateDrug (rng, iter->drug, iter->qty, iter->time);
+        ++iter;
     }
+    medicateQueue.erase( medicateQueue.begin(), iter );
+    day += 1;
 }
 
 void LSTMModel::medicateDrug(LocalRng& rng, size_t typeIndex, double qty, double time) {
-    //TODO: might be a little faster if m_drugs was pre-allocated with a slot for each drug type, using a null pointer
-    for( auto& drug : m_drugs ){
-        if (drug->getIndex() == typeIndex){
-            drug->medicate (time, qty);
-            return;
-        }
+    applyDecay();
+    drugsActive = true;
+    if( typeIndex < drugSlots.size() && drugSlots[typeIndex] != NO_SLOT ){
+        m_drugs[drugSlots[typeIndex]]->medicate (time, qty);
+        return;
     }
     // No match, so insert one:
+    if( typeIndex >= drugSlots.size() ) drugSlots.resize( LSTMDrugType::numDrugTypes(), NO_SLOT );
+    drugSlots[typeIndex] = m_drugs.size();
     m_drugs.push_back( LSTMDrugType::createInstance(rng, typeIndex) );
     (*m_drugs.back()).medicate (time, qty);
 }
 
-double LSTMModel::getDrugConc (size_t drug_index) const{
+double LSTMModel::getDrugConc (size_t drug_index){
+    applyDecay();
     double c = 0.0;
     double d = 0.0;
     for( auto& drug : m_drugs ){
@@ -132,7 +149,9 @@ double LSTMModel::getDrugConc (size_t drug_index) const{
     return c;
 }
 
-double LSTMModel::getDrugFactor (LocalRng& rng, WithinHost::CommonInfection *inf, double body_mass) const{
+double LSTMModel::getDrugFactor (LocalRng& rng, WithinHost::CommonInfection *inf, double body_mass){
+    if( !drugsActive ) return 1.0;
+    applyDecay();
     double factor = 1.0; //no effect
     
     for( auto drug = m_drugs.begin(), end = m_drugs.end(); drug != end; ++drug ){
@@ -145,19 +164,35 @@ double LSTMModel::getDrugFactor (LocalRng& rng, WithinHost::CommonInfection *inf
 void LSTMModel::decayDrugs (double body_mass) {
     // Update concentrations for each drug.
     // TODO: previously we removed drugs with negligible concentration here. What now, just set concentration to 0?
+    if( !drugsActive ) return;
+    if( !pendingDecay.empty() && pendingDecay.back().body_mass == body_mass ){
+        pendingDecay.back().days += 1;
+        return;
+    }
+    if( pendingDecay.size() >= MAX_PENDING_RUNS ) applyDecay();
+    pendingDecay.push_back( DecayRun{ body_mass, 1 } );
+}
+
+void LSTMModel::applyDecay(){
+    if( pendingDecay.empty() ) return;
+    drugsActive = false;
     for( auto& drug : m_drugs ){
-        drug->updateConcentration(body_mass);
+        drug->decay(pendingDecay);
+        drugsActive = drugsActive || drug->isActive();
     }
+    pendingDecay.clear();
 }
 
-void LSTMModel::summarize(const Host::Human& human) const{
+void LSTMModel::summarize(mon::HostSummary& summary){
+    if( !drugsActive ) return;     // all concentrations are zero
+    applyDecay();
     const vector<size_t> &drugsInUse( LSTMDrugType::getDrugsInUse() );
     for( size_t index : drugsInUse ){
         for( auto& drug : m_drugs ){
             double conc = drug->getConcentration(index);
             if( conc > 0.0 ){
-                mon::reportStatMHPI( mon::MHR_HOSTS_POS_DRUG_CONC, human, index, 1 );
-                mon::reportStatMHPF( mon::MHF_LOG_DRUG_CONC, human, index, log(conc) );
+                summary.reportPI( mon::MHR_HOSTS_POS_DRUG_CONC, index, 1 );
+                summary.reportPF( mon::MHF_LOG_DRUG_CONC, index, log(conc) );
             }
         }
     }
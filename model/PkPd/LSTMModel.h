@@ -28,6 +28,9 @@ namespace scnXml{
     class PKPDMedication;
 }
 namespace OM {
+namespace mon {
+    class HostSummary;
+}
 namespace Host{
     class Human;
 }
@@ -54,15 +57,30 @@ struct MedicateData {
 private:
     void load( const scnXml::PKPDMedication& med );
     
-    inline MedicateData multiplied( double doseMult ){
+    inline MedicateData multiplied( double doseMult ) const{
         MedicateData r( *this );
         r.qty *= doseMult;
         return r;
     }
     
+    /** Convert time (relative to the day starting with the next medicate()
+     * call) to a due day and the time within that day.
+     * 
+     * Subtracting the whole number of days is exact, thus time ends up the
+     * same as when decremented once per day. */
+    inline void setDue( uint32_t today ){
+        double days = time >= 1.0 ? floor(time) : 0.0;
+        dueDay = today + static_cast<uint32_t>( days );
+        time -= days;
+    }
+    
     size_t drug;      /// Drug type index
     double qty;         /// Quantity of drug prescribed in mg
-    double time;        /// Time to medicate at, in days (0 means start of time step, may be >= 1 (thus not today))
+    /** Time to medicate at, in days. Before setDue() is called, this is
+     * relative to the start of the next day (0 means start of day, may be
+     * >= 1 (thus not today)); after, relative to the start of dueDay. */
+    double time;
+    uint32_t dueDay = 0;        /// Day to medicate on (see LSTMModel::day); not checkpointed
     
     friend struct Schedule;
     friend class LSTMModel;
@@ -116,23 +134,27 @@ public:
     /** Get concentration of the drug at the beginning of the day.
      * 
      * For unit testing. Not optimised. */
-    double getDrugConc (size_t drug_index) const;
+    double getDrugConc (size_t drug_index);
     
     /** This is how drugs act on infections.
      *
      * Each time step, on each infection, the parasite density is multiplied by
      * the return value of this infection. The WithinHostModels are responsible
      * for clearing infections once the parasite density is negligible. */
-    double getDrugFactor (LocalRng& rng, WithinHost::CommonInfection *inf, double body_mass) const;
+    double getDrugFactor (LocalRng& rng, WithinHost::CommonInfection *inf, double body_mass);
     
     /** After any resident infections have been reduced by getDrugFactor(),
      * this function is called to update drug levels to their effective level
      * at the end of the day, as well as clear data once drug concentrations
-     * become negligible. */
+     * become negligible.
+     * 
+     * Decay is deferred until drug concentrations are next needed (see
+     * applyDecay()), thus hosts on prophylaxis without infections only
+     * update drugs when medicated or surveyed. */
     void decayDrugs (double body_mass);
     
     /** Make summaries of drug concentration data. */
-    void summarize( const Host::Human& human ) const;
+    void summarize( mon::HostSummary& summary );
     
 private:
     /** Medicate drugs to an individual, which act on infections the following
@@ -154,12 +176,39 @@ private:
     void checkpoint (istream& stream);
     void checkpoint (ostream& stream);
     
-    /// Drugs with non-zero blood concentrations:
+    /** Apply deferred decay (see decayDrugs()). Must be called before drug
+     * concentrations are read or doses added. Results are as if decay had
+     * been applied each day (up to rounding). */
+    void applyDecay();
+    
+    /// Drugs which have been used (in order of first use):
     vector<unique_ptr<LSTMDrug>> m_drugs;
     
-    /// All pending medications
-    list<MedicateData> medicateQueue;
+    /// Index in m_drugs by drug type index, or NO_SLOT. Sized on first use.
+    vector<uint32_t> drugSlots;
+    static const uint32_t NO_SLOT = numeric_limits<uint32_t>::max();
+    
+    /// True if any drug may be active (see LSTMDrug::isActive()).
+    bool drugsActive = false;
+    
+    /** Days of decay not yet applied to m_drugs, by body mass, in order.
+     * Body mass changes each step for children, hence several runs. Always
+     * empty when checkpointing. */
+    vector<DecayRun> pendingDecay;
+    /// Limit on pendingDecay.size(), bounding memory when hosts are rarely
+    /// surveyed.
+    static const size_t MAX_PENDING_RUNS = 32;
+    
+    /** Number of medicate() calls with a non-empty queue: days relative to
+     * which MedicateData::dueDay is stored. Not checkpointed (dueDay is
+     * converted back to a relative time). */
+    uint32_t day = 0;
+    
+    /// All pending medications, ordered by dueDay (stable with respect to
+    /// order of prescription)
+    vector<MedicateData> medicateQueue;
     
+    friend class DecayBatch;
     friend class ::UnittestUtil;
 };
 
@@ -24,6 +24,8 @@
 #include "PkPd/Drug/LSTMDrugType.h"
 #include "PkPd/LSTMModel.h"
 
+#include <map>
+
 namespace OM {
 namespace PkPd {
 
@@ -48,6 +50,9 @@ map<string,size_t> scheduleNames;
 void DosageTable::load( const xsd::cxx::tree::sequence<scnXml::PKPDDosageRange>& seq, bool isBodyMass ){
     useMass = isBodyMass;
     multMassKg = false;
+    // init() may be called again (e.g. by unit tests): replace, don't append
+    bounds.clear();
+    mults.clear();
     double lastMult = 0.0, lastAge = numeric_limits<double>::quiet_NaN();
     for( const scnXml::PKPDDosageRange& age : seq ){
         if( lastAge != lastAge ){
@@ -57,12 +62,14 @@ void DosageTable::load( const xsd::cxx::tree::sequence<scnXml::PKPDDosageRange>&
             if( age.getLowerbound() <= lastAge ){
                 throw util::xml_scenario_error( "dosage table must list age groups in increasing order" );
             }
-            table[age.getLowerbound()] = lastMult;
+            bounds.push_back( age.getLowerbound() );
+            mults.push_back( lastMult );
         }
         lastMult = age.getDose_mult();
         lastAge = age.getLowerbound();
     }
-    table[numeric_limits<double>::infinity()] = lastMult;
+    bounds.push_back( numeric_limits<double>::infinity() );
+    mults.push_back( lastMult );
 }
 
 vector<DosageTable> dosages;
@@ -131,129 +131,168 @@ void Population::checkpoint(ostream& stream)
         human.checkpoint(stream);
 }
 
-void registerContinousPopulationCallbacks()
-{
-    ostringstream ctsDemogTitle;
-    for( double ubound : ctsDemogAgeGroups )
-        ctsDemogTitle << "\thost % ≤ " << ubound;
-
-    mon::Continuous.registerCallback( "hosts", "\thosts", &ctsHosts );
-    mon::Continuous.registerCallback( "host demography", ctsDemogTitle.str(), &ctsHostDemography);
-    mon::Continuous.registerCallback( "recent births", "\trecent births", &ctsRecentBirths);
-    mon::Continuous.registerCallback( "patent hosts", "\tpatent hosts", &ctsPatentHosts);
-    mon::Continuous.registerCallback( "immunity h", "\timmunity h", &ctsImmunityh);
-    mon::Continuous.registerCallback( "immunity Y", "\timmunity Y", &ctsImmunityY);
-    mon::Continuous.registerCallback( "median immunity Y", "\tmedian immunity Y", &ctsMedianImmunityY);
-    mon::Continuous.registerCallback( "human age availability", "\thuman age availability", &ctsMeanAgeAvailEffect);
-    mon::Continuous.registerCallback( "ITN coverage", "\tITN coverage", &ctsITNCoverage);
-    mon::Continuous.registerCallback( "IRS coverage", "\tIRS coverage", &ctsIRSCoverage);
-    mon::Continuous.registerCallback( "GVI coverage", "\tGVI coverage", &ctsGVICoverage);
-}
-
-void ctsHosts (Population &population, ostream& stream){
-    // this option is intended for debugging human initialization; normally this should equal size.
-    stream << '\t' << population.getSize();
-}
-
-void ctsHostDemography (Population &population, ostream& stream){
-    auto iter = population.humans.crbegin();
-    int cumCount = 0;
-    for( double ubound : ctsDemogAgeGroups ){
-        while( iter != population.humans.crend() && sim::inYears(iter->age(sim::now())) < ubound ){
-            ++cumCount;
-            ++iter;
+namespace {
+/// Cumulative numbers of hosts under various age limits
+class CtsHostDemography : public mon::HumanAccumulator {
+    // number of hosts by age group; the last counts hosts above all limits
+    vector<int> counts;
+public:
+    void begin( const Population& ) override {
+        counts.assign( ctsDemogAgeGroups.size() + 1, 0 );
+    }
+    void add( Host::Human& human ) override {
+        double age = sim::inYears( human.age( sim::now() ) );
+        // first group with age < upper bound
+        size_t i = upper_bound( ctsDemogAgeGroups.begin(), ctsDemogAgeGroups.end(), age )
+            - ctsDemogAgeGroups.begin();
+        counts[i] += 1;
+    }
+    void write( const Population&, ostream& stream ) override {
+        int cumCount = 0;
+        for( size_t i = 0; i < ctsDemogAgeGroups.size(); ++i ){
+            cumCount += counts[i];
+            stream << '\t' << cumCount;
         }
-        stream << '\t' << cumCount;
     }
-}
-
-void ctsRecentBirths (Population &population, ostream& stream){
-    stream << '\t' << population.getRecentBirths();
-    population.resetRecentBirths();
-}
+};
 
-void ctsPatentHosts (Population &population, ostream& stream){
+/// Number of patent hosts
+class CtsPatentHosts : public mon::HumanAccumulator {
     int patent = 0;
-    for(Host::Human &human : population.humans) {
+public:
+    void begin( const Population& ) override {
+        patent = 0;
+    }
+    void add( Host::Human& human ) override {
         auto diag = WithinHost::diagnostics::monitoringDiagnostic();
         if( human.withinHostModel->diagnosticResult(human.rng, diag) )
             ++patent;
     }
-    stream << '\t' << patent;
-}
-
-void ctsImmunityh (Population &population, ostream& stream){
-    double x = 0.0;
-    for(const Host::Human &human : population.humans) {
-        x += human.withinHostModel->getCumulative_h();
+    void write( const Population&, ostream& stream ) override {
+        stream << '\t' << patent;
     }
-    x /= population.getSize();
-    stream << '\t' << x;
-}
+};
 
-void ctsImmunityY (Population &population, ostream& stream){
+/// Mean of immunity's cumulative h or Y parameter
+class CtsImmunity : public mon::HumanAccumulator {
+    bool useY;
     double x = 0.0;
-    for(const Host::Human &human : population.humans) {
-        x += human.withinHostModel->getCumulative_Y();
+public:
+    explicit CtsImmunity( bool useY ) : useY(useY) {}
+    void begin( const Population& ) override {
+        x = 0.0;
     }
-    x /= population.getSize();
-    stream << '\t' << x;
-}
+    void add( Host::Human& human ) override {
+        x += useY ? human.withinHostModel->getCumulative_Y() :
+            human.withinHostModel->getCumulative_h();
+    }
+    void write( const Population& population, ostream& stream ) override {
+        stream << '\t' << x / population.getSize();
+    }
+};
 
-void ctsMedianImmunityY (Population &population, ostream& stream){
+/// Median of immunity's cumulative Y parameter
+class CtsMedianImmunityY : public mon::HumanAccumulator {
     vector<double> list;
-    list.reserve( population.getSize() );
-    for(const Host::Human &human : population.humans) {
+public:
+    void begin( const Population& population ) override {
+        list.clear();
+        list.reserve( population.getSize() );
+    }
+    void add( Host::Human& human ) override {
         list.push_back( human.withinHostModel->getCumulative_Y() );
     }
-    sort( list.begin(), list.end() );
-    double x;
-    if( mod_nn(population.getSize(), 2) == 0 ){
+    void write( const Population& population, ostream& stream ) override {
+        // Partial sort: only the middle element(s) are needed
         size_t i = population.getSize() / 2;
-        x = (list[i-1]+list[i])/2.0;
-    }else{
-        x = list[population.getSize() / 2];
+        nth_element( list.begin(), list.begin() + i, list.end() );
+        double x;
+        if( mod_nn(population.getSize(), 2) == 0 ){
+            double below = *max_element( list.begin(), list.begin() + i );
+            x = (below+list[i])/2.0;
+        }else{
+            x = list[i];
+        }
+        stream << '\t' << x;
     }
-    stream << '\t' << x;
-}
+};
 
-void ctsMeanAgeAvailEffect (Population &population, ostream& stream){
+/// Mean age-based availability of humans exposed to transmission
+class CtsMeanAgeAvailEffect : public mon::HumanAccumulator {
     int nHumans = 0;
     double avail = 0.0;
-    for(Host::Human &human : population.humans) {
+public:
+    void begin( const Population& ) override {
+        nHumans = 0;
+        avail = 0.0;
+    }
+    void add( Host::Human& human ) override {
         if( !human.perHostTransmission.outsideTransmission ){
             ++nHumans;
             avail += human.perHostTransmission.relativeAvailabilityAge(sim::inYears(human.age(sim::now())));
         }
     }
-    stream << '\t' << avail/nHumans;
-}
+    void write( const Population&, ostream& stream ) override {
+        stream << '\t' << avail/nHumans;
+    }
+};
 
-void ctsITNCoverage (Population &population, ostream& stream){
+/// Proportion of the population with an active intervention component
+class CtsCoverage : public mon::HumanAccumulator {
+    interventions::Component::Type component;
     int nActive = 0;
-    for(const Host::Human &human : population.humans) {
-        nActive += human.perHostTransmission.hasActiveInterv( interventions::Component::ITN );
+public:
+    explicit CtsCoverage( interventions::Component::Type component ) : component(component) {}
+    void begin( const Population& ) override {
+        nActive = 0;
+    }
+    void add( Host::Human& human ) override {
+        nActive += human.perHostTransmission.hasActiveInterv( component );
     }
-    double coverage = static_cast<double>(nActive) / population.getSize();
-    stream << '\t' << coverage;
+    void write( const Population& population, ostream& stream ) override {
+        double coverage = static_cast<double>(nActive) / population.getSize();
+        stream << '\t' << coverage;
+    }
+};
 }
 
-void ctsIRSCoverage (Population &population, ostream& stream){
-    int nActive = 0;
-    for(const Host::Human &human : population.humans) {
-        nActive += human.perHostTransmission.hasActiveInterv( interventions::Component::IRS );
-    }
-    double coverage = static_cast<double>(nActive) / population.getSize();
-    stream << '\t' << coverage;
+void registerContinousPopulationCallbacks()
+{
+    ostringstream ctsDemogTitle;
+    for( double ubound : ctsDemogAgeGroups )
+        ctsDemogTitle << "\thost % ≤ " << ubound;
+
+    using mon::HumanAccumulator;
+    mon::Continuous.registerCallback( "hosts", "\thosts", &ctsHosts );
+    mon::Continuous.registerCallback( "host demography", ctsDemogTitle.str(),
+            unique_ptr<HumanAccumulator>(new CtsHostDemography) );
+    mon::Continuous.registerCallback( "recent births", "\trecent births", &ctsRecentBirths);
+    mon::Continuous.registerCallback( "patent hosts", "\tpatent hosts",
+            unique_ptr<HumanAccumulator>(new CtsPatentHosts) );
+    mon::Continuous.registerCallback( "immunity h", "\timmunity h",
+            unique_ptr<HumanAccumulator>(new CtsImmunity(false)) );
+    mon::Continuous.registerCallback( "immunity Y", "\timmunity Y",
+            unique_ptr<HumanAccumulator>(new CtsImmunity(true)) );
+    mon::Continuous.registerCallback( "median immunity Y", "\tmedian immunity Y",
+            unique_ptr<HumanAccumulator>(new CtsMedianImmunityY) );
+    mon::Continuous.registerCallback( "human age availability", "\thuman age availability",
+            unique_ptr<HumanAccumulator>(new CtsMeanAgeAvailEffect) );
+    mon::Continuous.registerCallback( "ITN coverage", "\tITN coverage",
+            unique_ptr<HumanAccumulator>(new CtsCoverage(interventions::Component::ITN)) );
+    mon::Continuous.registerCallback( "IRS coverage", "\tIRS coverage",
+            unique_ptr<HumanAccumulator>(new CtsCoverage(interventions::Component::IRS)) );
+    mon::Continuous.registerCallback( "GVI coverage", "\tGVI coverage",
+            unique_ptr<HumanAccumulator>(new CtsCoverage(interventions::Component::GVI)) );
 }
 
-void ctsGVICoverage (Population &population, ostream& stream){
-    int nActive = 0;
-    for(const Host::Human &human : population.humans) {
-        nActive += human.perHostTransmission.hasActiveInterv( interventions::Component::GVI );
-    }
-    double coverage = static_cast<double>(nActive) / population.getSize();
-    stream << '\t' << coverage;
+void ctsHosts (Population &population, ostream& stream){
+    // this option is intended for debugging human initialization; normally this should equal size.
+    stream << '\t' << population.getSize();
+}
+
+void ctsRecentBirths (Population &population, ostream& stream){
+    stream << '\t' << population.getRecentBirths();
+    population.resetRecentBirths();
 }
 
 }
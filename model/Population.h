@@ -73,23 +73,8 @@ void registerContinousPopulationCallbacks();
 
 /// Delegate to print the number of hosts
 void ctsHosts (Population &population, ostream& stream);
-/// Delegate to print cumulative numbers of hosts under various age limits
-void ctsHostDemography (Population &population, ostream& stream);
 /// Delegate to print the number of births since last count
 void ctsRecentBirths (Population &population, ostream& stream);
-/// Delegate to print the number of patent hosts
-void ctsPatentHosts (Population &population, ostream& stream);
-/// Delegate to print immunity's cumulativeh parameter
-void ctsImmunityh (Population &population, ostream& stream);
-/// Delegate to print immunity's cumulativeY parameter (mean across population)
-void ctsImmunityY (Population &population, ostream& stream);
-/// Delegate to print immunity's cumulativeY parameter (median across population)
-void ctsMedianImmunityY (Population &population, ostream& stream);
-/// Delegate to print the mean age-based availability reduction of each human relative to an adult
-void ctsMeanAgeAvailEffect (Population &population, ostream& stream);
-void ctsITNCoverage (Population &population, ostream& stream);
-void ctsIRSCoverage (Population &population, ostream& stream);
-void ctsGVICoverage (Population &population, ostream& stream);
 
 inline size_t Population::getSize() const {
     return size;
@@ -226,9 +226,12 @@ public:
      *    The human's "per host transmission" potentially needs updating.
      * @param age Age of the human in time units
      * @param ageYears Age of the human in years
-     * @param EIR Out-vector of EIR per parasite genotype. The length is also set
-     *    by the called function. Where genotype tracking is not supported (e.g.
-     *    the non-vector model), the length is set to one.
+     * @param EIR_i, EIR_l Out-vectors of EIR per parasite genotype (imported
+     *    and local). The length is also set by the called function. Where
+     *    genotype tracking is not supported (e.g. the non-vector model), the
+     *    length is set to one. Implementations overwrite every element
+     *    (e.g. with vector::assign), so callers may reuse the same vectors
+     *    to avoid reallocation.
      * @returns the sum of EIR across genotypes
      */
     double getEIR(Host::Human &human, SimTime age, double ageYears, vector<double> &EIR_i, vector<double> &EIR_l)
@@ -267,6 +270,7 @@ public:
         double sumWeight = 0.0;
         numTransmittingHumans = 0;
 
+        vector<double> probTransGenotype_i, probTransGenotype_l;
         for (const Host::Human &human : population)
         {
             // NOTE: calculate availability relative to age at end of time step;
@@ -274,8 +278,8 @@ public:
             const double avail = human.perHostTransmission.relativeAvailabilityHetAge(sim::inYears(human.age(sim::ts1())));
             sumWeight += avail;
 
-            vector<double> probTransGenotype_i(WithinHost::Genotypes::N());
-            vector<double> probTransGenotype_l(WithinHost::Genotypes::N());
+            probTransGenotype_i.assign(WithinHost::Genotypes::N(), 0.0);
+            probTransGenotype_l.assign(WithinHost::Genotypes::N(), 0.0);
             const double pTransmit = human.withinHostModel->probTransmissionToMosquito(probTransGenotype_i, probTransGenotype_l);
 
             double riskTrans = 0.0;
@@ -354,7 +358,8 @@ protected:
      * @param ageGroupData Age group of this host for availablility data.
      * @param EIR Out-vector. Set to the age- and heterogeneity-specific EIR an
      *    individual human is exposed to, per parasite genotype, in units of
-     *    inoculations per day. Length set by callee. 
+     *    inoculations per day. Length set by callee, which must write every
+     *    element since the vectors may hold values from a previous call.
      *    _i for imported infections and _l for local infections */
     virtual void calculateEIR(Host::Human &human, double ageYears, vector<double> &EIR_i, vector<double> &EIR_l) const = 0;
 
@@ -93,42 +93,35 @@ void VectorModel::ctsCbS_v(ostream &stream)
     for (size_t i = 0; i < speciesIndex.size(); ++i)
         stream << '\t' << species[i]->getLastVecStat(Anopheles::SV);
 }
-void VectorModel::ctsCbAlpha(const vector<Host::Human> &population, ostream &stream)
-{
-    for (size_t i = 0; i < speciesIndex.size(); ++i)
-    {
-        double total = 0.0;
-        for (const Host::Human &human : population)
-        {
-            total += human.perHostTransmission.entoAvailabilityFull(i, sim::inYears(human.age(sim::now())));
-        }
-        stream << '\t' << total / population.size();
+namespace {
+/// Continuous output: mean over humans of some value f(human, species), for each species
+template<typename F>
+class CtsSpeciesMean : public mon::HumanAccumulator {
+    vector<double> totals;
+    size_t nHumans = 0;
+    F f;
+public:
+    CtsSpeciesMean( size_t numSpecies, F f ) : totals(numSpecies), f(f) {}
+    void begin( const Population& ) override {
+        fill( totals.begin(), totals.end(), 0.0 );
+        nHumans = 0;
     }
-}
-void VectorModel::ctsCbP_B(const vector<Host::Human> &population, ostream &stream)
-{
-    for (size_t i = 0; i < speciesIndex.size(); ++i)
-    {
-        double total = 0.0;
-        for (const Host::Human &human : population)
-        {
-            total += human.perHostTransmission.probMosqBiting(i);
-        }
-        stream << '\t' << total / population.size();
+    void add( Host::Human& human ) override {
+        for (size_t i = 0; i < totals.size(); ++i)
+            totals[i] += f( human, i );
+        ++nHumans;
     }
-}
-void VectorModel::ctsCbP_CD(const vector<Host::Human> &population, ostream &stream)
-{
-    for (size_t i = 0; i < speciesIndex.size(); ++i)
-    {
-        double total = 0.0;
-        for (const Host::Human &human : population)
-        {
-            total += human.perHostTransmission.probMosqResting(i);
-        }
-        stream << '\t' << total / population.size();
+    void write( const Population&, ostream& stream ) override {
+        for (double total : totals)
+            stream << '\t' << total / nHumans;
     }
+};
+template<typename F>
+unique_ptr<mon::HumanAccumulator> ctsSpeciesMean( size_t numSpecies, F f ){
+    return unique_ptr<mon::HumanAccumulator>( new CtsSpeciesMean<F>( numSpecies, f ) );
 }
+}
+
 void VectorModel::ctsNetInsecticideContent(const vector<Host::Human> &population, ostream &stream)
 {
     //     double meanVar = 0.0;
@@ -248,9 +241,18 @@ VectorModel::VectorModel(vector<double> initEIR, int interventionMode, vector<st
     Continuous.registerCallback("S_v", ctsSv.str(), std::bind( &VectorModel::ctsCbS_v, this, _1));
 
     // availability to mosquitoes relative to other humans, excluding age factor
-    Continuous.registerCallback("alpha", ctsAlpha.str(), std::bind( &VectorModel::ctsCbAlpha, this, _1, _2));
-    Continuous.registerCallback("P_B", ctsPB.str(), std::bind( &VectorModel::ctsCbP_B, this, _1, _2));
-    Continuous.registerCallback("P_C*P_D", ctsPCD.str(), std::bind( &VectorModel::ctsCbP_CD, this, _1, _2));
+    Continuous.registerCallback("alpha", ctsAlpha.str(), ctsSpeciesMean( numSpecies,
+        [](const Host::Human &human, size_t i){
+            return human.perHostTransmission.entoAvailabilityFull(i, sim::inYears(human.age(sim::now())));
+        } ));
+    Continuous.registerCallback("P_B", ctsPB.str(), ctsSpeciesMean( numSpecies,
+        [](const Host::Human &human, size_t i){
+            return human.perHostTransmission.probMosqBiting(i);
+        } ));
+    Continuous.registerCallback("P_C*P_D", ctsPCD.str(), ctsSpeciesMean( numSpecies,
+        [](const Host::Human &human, size_t i){
+            return human.perHostTransmission.probMosqResting(i);
+        } ));
 
     Continuous.registerCallback("resource availability", ctsRA.str(), std::bind( &VectorModel::ctsCbResAvailability, this, _1));
     Continuous.registerCallback("resource requirements", ctsRR.str(), std::bind( &VectorModel::ctsCbResRequirements, this, _1));
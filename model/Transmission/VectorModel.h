@@ -95,9 +95,6 @@ private:
     void ctsCbN_v(ostream &stream);
     void ctsCbO_v(ostream &stream);
     void ctsCbS_v(ostream &stream);
-    void ctsCbAlpha(const vector<Host::Human> &population, ostream &stream);
-    void ctsCbP_B(const vector<Host::Human> &population, ostream &stream);
-    void ctsCbP_CD(const vector<Host::Human> &population, ostream &stream);
     void ctsNetInsecticideContent(const vector<Host::Human> &population, ostream &stream);
     void ctsIRSInsecticideContent(const vector<Host::Human> &population, ostream &stream);
     void ctsIRSEffects(const vector<Host::Human> &population, ostream &stream);
@@ -26,6 +26,7 @@
 #include "util/ModelOptions.h"
 #include "util/StreamValidator.h"
 #include "util/DocumentLoader.h"
+#include "util/Benchmark.h"
 
 #include "mon/Continuous.h"
 #include "mon/management.h"
@@ -34,6 +35,7 @@
 #include "Clinical/ClinicalModel.h"
 
 #include "Host/NeonatalMortality.h"
+#include "PkPd/DecayBatch.h"
 #include "checkpoint.h"
 
 #include "schema/scenario.h"
@@ -82,12 +84,30 @@ void run(Population &population, TransmissionModel &transmission, SimTime humanW
 
         // Monitoring. sim::now() gives time of end of last step,
         // and is when reporting happens in our time-series.
-        Continuous.update( population );
+        {
+            util::benchmark::ScopedTimer timer(util::benchmark::CONTINUOUS);
+            Continuous.update( population );
+        }
         if( sim::intervDate() == mon::nextSurveyDate() ){
+            util::benchmark::ScopedTimer timer(util::benchmark::SURVEY, population.humans.size());
+            // Drug decay deferred since the last survey is needed now; apply
+            // it for all hosts together, grouping those with the same schedule.
+            static PkPd::DecayBatch decayBatch;
+            for(Host::Human &human : population.humans)
+                human.withinHostModel->addToDecayBatch( decayBatch );
+            decayBatch.apply();
             for(Host::Human &human : population.humans)
                 Host::summarize(human, surveyOnlyNewEp);
             transmission.summarize();
             mon::concludeSurvey();
+            
+            if( util::CommandLine::option(util::CommandLine::STREAM_OUTPUT) ){
+                // Episodes report to their survey lazily; once all episodes
+                // which could still report to a survey have expired, it can be written.
+                for(Host::Human &human : population.humans)
+                    human.clinicalModel->reportExpiredEpisode( human );
+                mon::writeConcludedSurveys( sim::now() - Clinical::ClinicalModel::hsMemory() );
+            }
         }
         
         // Deploy interventions, at time sim::now().
@@ -99,24 +119,43 @@ void run(Population &population, TransmissionModel &transmission, SimTime humanW
 
         // This should be called before humans contract new infections in the simulation step.
         // This needs the whole population (it is an approximation before all humans are updated).
-        transmission.vectorUpdate(population.humans);
+        {
+            util::benchmark::ScopedTimer timer(util::benchmark::TRANSMISSION);
+            transmission.vectorUpdate(population.humans);
+        }
         
         // NOTE: no neonatal mortalities will occur in the first 20 years of warmup
         // (until humans old enough to be pregnate get updated and can be infected).
         Host::NeonatalMortality::update (population.humans);
         
-        for (Host::Human& human : population.humans)
         {
-            if (human.getDOB() + sim::maxHumanAge() >= humanWarmupLength) // this is last time of possible update
-                Host::update(human, transmission);
+            util::benchmark::ScopedTimer timer(util::benchmark::HUMAN_UPDATE, population.humans.size());
+            // With --report-buffers N, humans report to N buffers in contiguous
+            // blocks, as they would with one thread per block.
+            const size_t nBuffers = util::CommandLine::getReportBuffers();
+            const size_t nHumans = population.humans.size();
+            size_t n = 0;
+            for (Host::Human& human : population.humans)
+            {
+                if (nBuffers > 0) mon::useReportBuffer(n++ * nBuffers / nHumans);
+                if (human.getDOB() + sim::maxHumanAge() >= humanWarmupLength) // this is last time of possible update
+                    Host::update(human, transmission);
+            }
+            if (nBuffers > 0) {
+                mon::useReportStores();
+                mon::mergeReportBuffers();
+            }
         }
        
         population.update();
         
-        // Doesn't matter whether non-updated humans are included (value isn't used
-        // before all humans are updated).
-        transmission.updateKappa(population.humans);
-        transmission.surveyEIR();
+        {
+            util::benchmark::ScopedTimer timer(util::benchmark::TRANSMISSION);
+            // Doesn't matter whether non-updated humans are included (value isn't used
+            // before all humans are updated).
+            transmission.updateKappa(population.humans);
+            transmission.surveyEIR();
+        }
 
         sim::end_update();
 
@@ -142,6 +181,8 @@ int main(int argc, char* argv[])
         util::set_gsl_handler();
         
         scenarioFile = util::CommandLine::parse (argc, argv);
+        if( util::CommandLine::option(util::CommandLine::BENCHMARK) )
+            util::benchmark::init();
         unique_ptr<scnXml::Scenario> scenario = util::loadScenario(scenarioFile);
 
         sim::init(*scenario);
@@ -157,6 +198,7 @@ int main(int argc, char* argv[])
         // 2) elements depending on only elements initialised in (1):
         WithinHost::diagnostics::init( parameters, *scenario ); // Depends on Parameters
         mon::initReporting( *scenario ); // Reporting init depends on diagnostics and monitoring
+        mon::setReportBuffers( util::CommandLine::getReportBuffers() );
         
         // Init models used by humans
         Transmission::PerHost::init( scenario->getModel().getHuman().getAvailabilityToMosquitoes() );
@@ -281,11 +323,16 @@ int main(int argc, char* argv[])
         run(*population, *transmission, humanWarmupLength, endTime, estEndTime, surveyOnlyNewEp, "Intervention period");
        
         cerr << '\r' << flush;  // clean last line of progress-output
+        Continuous.close();
         
         for(Host::Human &human : population->humans)
             human.clinicalModel->flushReports();
 
-        mon::writeSurveyData();
+        {
+            util::benchmark::ScopedTimer timer(util::benchmark::OUTPUT);
+            mon::writeSurveyData();
+        }
+        util::benchmark::report( cerr );
         
     # ifdef OM_STREAM_VALIDATOR
         util::StreamValidator.saveStream();
@@ -0,0 +1,106 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2022 University of Basel
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "mon/BinaryOutput.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace OM {
+namespace mon {
+namespace binary {
+
+const char MAGIC[8] = { 'O', 'M', 'S', 'U', 'R', 'V', 'E', 'Y' };
+const uint32_t VERSION = 1;
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+template<typename T>
+inline void put( std::ostream& stream, T x ){
+    stream.write( reinterpret_cast<const char*>(&x), sizeof(T) );
+}
+inline void putString( std::ostream& stream, const std::string& s ){
+    const uint8_t len = static_cast<uint8_t>( std::min<size_t>( s.size(), 255 ) );
+    put( stream, len );
+    stream.write( s.data(), len );
+}
+template<typename T>
+inline void putColumn( std::ostream& stream, const std::vector<T>& col ){
+    stream.write( reinterpret_cast<const char*>(col.data()), col.size() * sizeof(T) );
+}
+
+void Columns::clear(){
+    survey.clear();
+    ageGroup.clear();
+    cohort.clear();
+    species.clear();
+    genotype.clear();
+    drug.clear();
+    measure.clear();
+    value.clear();
+}
+
+void writeHeader( std::ostream& stream, const std::vector<MeasureInfo>& measures ){
+    stream.write( MAGIC, sizeof(MAGIC) );
+    put( stream, VERSION );
+    put( stream, BYTE_ORDER_MARK );
+
+    // Column order must match writeBlock
+    const std::pair<ColumnType, const char*> columns[] = {
+        { UINT32, "survey" }, { UINT32, "ageGroup" }, { UINT32, "cohort" },
+        { UINT32, "species" }, { UINT32, "genotype" }, { UINT32, "drug" },
+        { INT32, "measure" }, { FLOAT64, "value" }
+    };
+    put( stream, static_cast<uint32_t>( sizeof(columns) / sizeof(columns[0]) ) );
+    for( auto& col : columns ){
+        put( stream, static_cast<uint8_t>( col.first ) );
+        putString( stream, col.second );
+    }
+
+    put( stream, static_cast<uint32_t>( measures.size() ) );
+    for( const MeasureInfo& m : measures ){
+        put( stream, m.outId );
+        put( stream, static_cast<uint8_t>( m.isDouble ? 1 : 0 ) );
+        putString( stream, m.name );
+    }
+}
+
+void writeBlock( std::ostream& stream, const Columns& cols ){
+    const uint64_t n = cols.size();
+    if( n == 0 ) return;        // zero is the end marker
+    assert( cols.survey.size() == n && cols.measure.size() == n );
+    put( stream, n );
+    putColumn( stream, cols.survey );
+    putColumn( stream, cols.ageGroup );
+    putColumn( stream, cols.cohort );
+    putColumn( stream, cols.species );
+    putColumn( stream, cols.genotype );
+    putColumn( stream, cols.drug );
+    putColumn( stream, cols.measure );
+    putColumn( stream, cols.value );
+}
+
+void writeEnd( std::ostream& stream ){
+    put( stream, static_cast<uint64_t>( 0 ) );
+}
+
+}
+}
+}
@@ -0,0 +1,106 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2022 University of Basel
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef H_OM_mon_BinaryOutput
+#define H_OM_mon_BinaryOutput
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/** Binary columnar survey output (command-line option --binary-output).
+ *
+ * This holds the same data as the text output, but each category gets its
+ * own typed column, so that nothing needs formatting or parsing. The file
+ * is read by util/readBinaryOutput.py.
+ *
+ * Layout. Numbers are in the writer's native byte order; readers detect it
+ * from the byte-order mark. Strings are a uint8 length followed by that many
+ * bytes (no terminator).
+ *
+ *  header:
+ *      char[8]     magic "OMSURVEY"
+ *      uint32      format version (1)
+ *      uint32      byte-order mark 0x01020304
+ *      uint32      number of columns, C
+ *      C times:    uint8 type code (ColumnType), string name
+ *      uint32      number of measures, M
+ *      M times:    int32 output number, uint8 value type (0: int,
+ *                  1: double), string name
+ *  blocks (one per survey, then one holding the infant mortality rate):
+ *      uint64      number of rows, N (> 0)
+ *      C times:    N values of the column's type
+ *  end:
+ *      uint64      0
+ *
+ * Columns, numbered as in the text output: survey (from 1), ageGroup (from
+ * 1; 0 if not categorised by age), cohort (output cohort number), species
+ * (from 1; 0 if not by species), genotype (from 0), drug (from 1; 0 if not
+ * by drug), measure (output number) and value. Integer measures are stored
+ * exactly in the float64 value column.
+ */
+namespace OM {
+namespace mon {
+namespace binary {
+
+enum ColumnType : uint8_t { INT32 = 1, UINT32 = 2, FLOAT64 = 3 };
+
+/// Description of one output measure, written to the header
+struct MeasureInfo {
+    int32_t outId;
+    bool isDouble;
+    std::string name;
+};
+
+/// Rows of output accumulated column by column
+struct Columns {
+    std::vector<uint32_t> survey, ageGroup, cohort, species, genotype, drug;
+    std::vector<int32_t> measure;
+    std::vector<double> value;
+
+    inline size_t size() const{ return value.size(); }
+    void clear();
+    inline void push( uint32_t s, uint32_t a, uint32_t c, uint32_t sp,
+            uint32_t g, uint32_t d, int32_t m, double v )
+    {
+        survey.push_back(s);
+        ageGroup.push_back(a);
+        cohort.push_back(c);
+        species.push_back(sp);
+        genotype.push_back(g);
+        drug.push_back(d);
+        measure.push_back(m);
+        value.push_back(v);
+    }
+};
+
+/// Write the file header
+void writeHeader( std::ostream& stream, const std::vector<MeasureInfo>& measures );
+/// Write one block of rows (does nothing when cols is empty)
+void writeBlock( std::ostream& stream, const Columns& cols );
+/// Write the end marker
+void writeEnd( std::ostream& stream );
+
+}
+}
+}
+#endif
@@ -24,11 +24,15 @@
 #include "util/errors.h"
 #include "util/CommandLine.h"
 #include "util/UnitParse.h"
+#include "util/TextOutput.h"
 #include "schema/monitoring.h"
 
 #include <vector>
 #include <map>
 #include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cassert>
 #include <gzstream/gzstream.h>
 
 namespace OM {
@@ -38,20 +42,91 @@ namespace OM {
         /// File we output to
         string cts_filename;
 
+        /// Stream buffer collecting output lines in memory, so that they can
+        /// be written to file in bulk.
+        class CtsBuffer : public std::streambuf {
+        public:
+            inline const char* data() const{ return pbase(); }
+            inline size_t size() const{ return pptr() - pbase(); }
+            inline void clear(){ setp( buf.data(), buf.data() + buf.size() ); }
+        protected:
+            int_type overflow( int_type c ) override {
+                const size_t used = size();
+                buf.resize( std::max<size_t>( 2 * buf.size(), 1 << 12 ) );
+                setp( buf.data(), buf.data() + buf.size() );
+                pbump( static_cast<int>(used) );
+                if( !traits_type::eq_int_type( c, traits_type::eof() ) ){
+                    *pptr() = traits_type::to_char_type( c );
+                    pbump( 1 );
+                }
+                return traits_type::not_eof( c );
+            }
+        private:
+            vector<char> buf;
+        };
+        CtsBuffer ctsBuffer;
+
         /// This is used to output some statistics in a tab-deliminated-value file.
         /// (It used to be csv, but German Excel can't open csv directly.)
-        fstream ctsOStream;
+        /// Output goes to ctsBuffer, then to the file once it holds this much:
+        ostream ctsOStream( &ctsBuffer );
+        const size_t ctsWriteSize = 1 << 16;
+
+        /// The output file (ctsFile points to one of these when open)
+        ofstream ctsPlainFile;
+        ogzstream ctsGzFile;
+        ostream* ctsFile = nullptr;
 
-        /* Record last position in file (as position minus start), for checkpointing.
-         * Don't use a streampos directly, because I'm not convinced we can save and
-         * reload a streampos and use on a new file. */
+        /* Size of the output file at the last checkpoint. On resume, the file is
+         * truncated to this size, thus anything written after the checkpoint is
+         * discarded (and will be repeated). */
         streamoff streamOff;
-        streampos streamStart;
 
-        map<string, tuple<string, std::function<void(Population&, ostream&)>> > registered;
+        inline bool compressCtsout(){
+            return util::CommandLine::option( util::CommandLine::COMPRESS_CTSOUT );
+        }
+
+        // Open the output file (mode is ios::out, or ios::out | ios::app to append).
+        // With compression, appending starts a new gzip member.
+        static void openFile( ios::openmode mode ){
+            if( compressCtsout() ){
+                ctsGzFile.clear();
+                ctsGzFile.open( cts_filename.c_str(), mode | ios::binary );
+                ctsFile = &ctsGzFile;
+            }else{
+                ctsPlainFile.clear();
+                ctsPlainFile.open( cts_filename.c_str(), mode | ios::binary );
+                ctsFile = &ctsPlainFile;
+            }
+        }
+        static void closeFile(){
+            if( compressCtsout() ) ctsGzFile.close();
+            else ctsPlainFile.close();
+        }
+
+        // Write buffered output to the file
+        static void writeBuffer(){
+            if( ctsBuffer.size() == 0 ) return;
+            assert( ctsFile != nullptr );
+            ctsFile->write( ctsBuffer.data(), ctsBuffer.size() );
+            ctsBuffer.clear();
+            if( ctsFile->fail() )
+                throw util::base_exception( "Continuous: unable to write " + cts_filename,
+                        util::Error::FileIO );
+        }
+
+        struct CtsCallback {
+            string titles;
+            // Either a callback function or an accumulator
+            std::function<void(Population&, ostream&)> f;
+            shared_ptr<HumanAccumulator> acc;
+        };
+        map<string, CtsCallback> registered;
 
         // List that we report.
-        vector< tuple<string, std::function<void(Population&, ostream&)>> > toReport;
+        vector<CtsCallback> toReport;
+        // Accumulators in toReport, fed by a single pass over humans.
+        vector<HumanAccumulator*> accumulators;
 
         SimTime ctsPeriod = sim::zero();
 
@@ -59,7 +134,27 @@ namespace OM {
 
         ContinuousType Continuous;
 
-        ContinuousType::~ContinuousType() {}
+        ContinuousType::~ContinuousType() {
+            // Write anything still buffered (e.g. when exiting on an error)
+            if( ctsFile != nullptr ){
+                try{
+                    close();
+                }catch( const std::exception& ){}
+            }
+        }
+
+        void ContinuousType::close(){
+            if( ctsFile == nullptr ) return;      // disabled or already closed
+            writeBuffer();
+            closeFile();
+            ctsFile = nullptr;
+        }
+
+        static void enableOutput( const CtsCallback& cb ){
+            toReport.push_back( cb );
+            if( cb.acc )
+                accumulators.push_back( cb.acc.get() );
+        }
 
         /* Initialise: enable outputs registered and requested in XML.
          * Search for Continuous::registerCallback to see outputs available. */
@@ -82,48 +177,46 @@ namespace OM {
                 duringInit = ctsOpt.get().getDuringInit().get();
 
             cts_filename = util::CommandLine::getCtsoutName();
+            if( compressCtsout() )
+                cts_filename.append( ".gz" );
 
             ctsOStream.width (0);
+            util::text::imbue( ctsOStream );
 
+            scnXml::OptionSet::OptionSequence sOSeq = ctsOpt.get().getOption();
             if( isCheckpoint ){
-                scnXml::OptionSet::OptionSequence sOSeq = ctsOpt.get().getOption();
                 for(scnXml::OptionSet::OptionConstIterator it = sOSeq.begin(); it != sOSeq.end(); ++it) {
                     auto reg_it = registered.find( it->getName() );
                     if( reg_it == registered.end() )
                         throw xml_scenario_error("monitoring.continuous: no output " + string(it->getName()));
                     if( it->getValue() ){
-                        toReport.push_back( reg_it->second );
+                        enableOutput( reg_it->second );
                     }
                 }
-
-                // When loading a check-point, we resume reporting to this file.
-                // Use "ate" mode and seek to desired pos.
-                ctsOStream.open (cts_filename.c_str(), ios::binary|ios::ate|ios::in|ios::out );
-                if( ctsOStream.fail() )
-                    throw util::checkpoint_error ("Continuous: resume error (no file)");
-                ctsOStream.seekp( 0, ios_base::beg );
-                streamStart = ctsOStream.tellp();
-                // we set position later, in staticCheckpoint
+                // When loading a check-point, we resume reporting to this file;
+                // it is opened by checkpoint().
             }else{
-                ctsOStream.open( cts_filename.c_str(), ios::binary|ios::out );
-                streamStart = ctsOStream.tellp();
-                ctsOStream << "##\t##" << endl;	// live-graph needs a deliminator specifier when it's not a comma
+                openFile( ios::out );
+                if( ctsFile->fail() )
+                    throw util::base_exception( "Continuous: unable to open " + cts_filename,
+                            util::Error::FileIO );
+                ctsOStream << "##\t##" << mon::lineEnd;	// live-graph needs a deliminator specifier when it's not a comma
 
                 if( duringInit )
                     ctsOStream << "simulation time\t";
                 ctsOStream << "timestep";   //TODO: change to days or remove or leave?
-                scnXml::OptionSet::OptionSequence sOSeq = ctsOpt.get().getOption();
                 for(scnXml::OptionSet::OptionConstIterator it = sOSeq.begin(); it != sOSeq.end(); ++it) {
                     auto reg_it = registered.find( it->getName() );
                     if( reg_it == registered.end() )
                         throw xml_scenario_error("monitoring.continuous: no output " + string(it->getName()));
                     if( it->getValue() ){
-                        ctsOStream << std::get<0>(reg_it->second);
-                        toReport.push_back( reg_it->second );
+                        ctsOStream << reg_it->second.titles;
+                        enableOutput( reg_it->second );
                     }
                 }
-                ctsOStream << mon::lineEnd << flush;
-                streamOff = ctsOStream.tellp() - streamStart;
+                ctsOStream << mon::lineEnd;
+                writeBuffer();
+                ctsFile->flush();
             }
         }
 
@@ -131,6 +224,19 @@ namespace OM {
             if( ctsPeriod == sim::zero() )
                 return;	// output disabled
 
+            // Write everything reported so far. With compression, also end
+            // the gzip member, so that the file may be truncated here.
+            writeBuffer();
+            if( compressCtsout() ){
+                closeFile();
+                openFile( ios::out | ios::app );
+            }else{
+                ctsFile->flush();
+            }
+            if( ctsFile->fail() )
+                throw util::base_exception( "Continuous: unable to write " + cts_filename,
+                        util::Error::FileIO );
+            streamOff = std::filesystem::file_size( cts_filename );
             streamOff & stream;
         }
         void ContinuousType::checkpoint (istream& stream){
@@ -138,34 +244,41 @@ namespace OM {
                 return;	// output disabled
 
             /* We attempt to resume output correctly after a reload by recording
-            * the last position, and relocating there.
+            * the last size, and truncating to that.
             * 
             * (Keeping results in memory until end of sim would be another,
             * slightly safer, option, but loses real-time output.) */
             streamOff & stream;
-            // We skip back to the last write-point, so anything written after the
-            // last checkpoint will be repeated:
-            ctsOStream.seekp( streamOff, ios_base::beg );
-
-            if( ctsOStream.fail() )
+            // Anything written after the last checkpoint will be repeated:
+            std::error_code ec;
+            std::filesystem::resize_file( cts_filename, streamOff, ec );
+            if( ec )
+                throw util::checkpoint_error ("Continuous: resume error (no file)");
+            openFile( ios::out | ios::app );
+            if( ctsFile->fail() )
                 throw util::checkpoint_error ("Continuous: resume error (bad pos/file)");
         }
 
         void ContinuousType::registerCallback (string optName, string titles, function<void(ostream&)> f){
             assert(registered.count(optName) == 0); // name clash/registered twice?
             function<void(const Population&, ostream&)> _f = [f](const Population&, ostream& ostream){ f(ostream); };
-            registered[optName] = {titles, _f};
+            registered[optName] = {titles, _f, nullptr};
         }
 
         void ContinuousType::registerCallback (string optName, string titles, function<void(const vector<Host::Human> &, ostream&)> f){
             assert(registered.count(optName) == 0); // name clash/registered twice?
             function<void(const Population&, ostream&)> _f = [f](const Population &p, ostream& ostream){ f(p.humans, ostream); };
-            registered[optName] = {titles, _f};
+            registered[optName] = {titles, _f, nullptr};
         }
 
         void ContinuousType::registerCallback (string optName, string titles, function<void(Population &, ostream&)> f){
             assert(registered.count(optName) == 0); // name clash/registered twice?
-            registered[optName] = {titles, f};
+            registered[optName] = {titles, f, nullptr};
+        }
+
+        void ContinuousType::registerCallback (string optName, string titles, unique_ptr<HumanAccumulator> acc){
+            assert(registered.count(optName) == 0); // name clash/registered twice?
+            registered[optName] = {titles, nullptr, shared_ptr<HumanAccumulator>(move(acc))};
         }
 
         void ContinuousType::update (Population &population){
@@ -188,14 +301,23 @@ namespace OM {
                 // breaking change and (2) it may be harder to use.
                 ctsOStream << sim::inSteps(sim::intervTime());
             }
-            for( size_t i = 0; i < toReport.size(); ++i )
-                std::get<1>(toReport[i])( population, ctsOStream );
-
-            // We must flush often to avoid temporarily outputting partial lines
-            // (resulting in incorrect real-time graphs).
-            ctsOStream << mon::lineEnd << flush;
+            if( !accumulators.empty() ){
+                for( HumanAccumulator* acc : accumulators )
+                    acc->begin( population );
+                for( Host::Human& human : population.humans ){
+                    for( HumanAccumulator* acc : accumulators )
+                        acc->add( human );
+                }
+            }
+            for( const CtsCallback& cb : toReport ){
+                if( cb.acc ) cb.acc->write( population, ctsOStream );
+                else cb.f( population, ctsOStream );
+            }
 
-            streamOff = ctsOStream.tellp() - streamStart;
+            // Lines are only written to file whole, in bulk.
+            ctsOStream << mon::lineEnd;
+            if( ctsBuffer.size() >= ctsWriteSize )
+                writeBuffer();
         }
     }
 }
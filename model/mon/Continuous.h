@@ -28,12 +28,30 @@
 #include "Host/Human.h"
 
 #include <functional>
+#include <memory>
 
 namespace scnXml{ class Monitoring; }
 namespace OM {
     class Population;
 namespace mon {
     
+    /** Continuous output computed from the whole human population.
+     *
+     * Outputs of this type are computed together, in a single pass over the
+     * population per output step: begin() is called on each enabled
+     * accumulator, then add() for each human (in population order), then
+     * write() when the output's column is due. */
+    class HumanAccumulator {
+    public:
+        virtual ~HumanAccumulator() {}
+        /// Reset before a pass over the population
+        virtual void begin( const Population& population ) =0;
+        /// Accumulate data from one human
+        virtual void add( Host::Human& human ) =0;
+        /// Output data, with each entry preceeded by '\t'
+        virtual void write( const Population& population, ostream& stream ) =0;
+    };
+    
     /** Class to deal with continuous output data.
      *
      * Requirements:
@@ -75,11 +93,18 @@ namespace mon {
     void registerCallback (string optName, string titles, function<void(const vector<Host::Human> &, ostream&)> f);
 
     void registerCallback (string optName, string titles, function<void(Population &, ostream&)> f);
+
+    /// As above, for outputs which pass over the whole population
+    void registerCallback (string optName, string titles, unique_ptr<HumanAccumulator> acc);
 	
 	/// Generate time-step's output. Called at beginning of time step.
         /// Passed population since some callbacks use this to generate output.
+        /// Output is buffered and written to file in bulk.
 	void update (Population &population);
         
+        /// Write buffered output and close the file. Call at the end of the simulation.
+        void close ();
+        
     private:
         void checkpoint(ostream& stream);
         void checkpoint(istream& stream);
@@ -0,0 +1,64 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2022 University of Basel
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef H_OM_mon_ReportBuffer
+#define H_OM_mon_ReportBuffer
+
+#include <cassert>
+#include <utility>
+#include <vector>
+
+namespace OM {
+namespace mon {
+
+/** Reports collected apart from the survey store (see setReportBuffers()).
+ *
+ * Reports are recorded as (index, value) pairs in the order made, so memory
+ * use depends on the number of reports since the last merge, not on the
+ * number of surveys held by the store. Merging adds them in the same order,
+ * thus gives the same result as adding to the store directly. */
+template<typename T>
+class ReportBuffer {
+public:
+    /// True if nothing was added since the last merge
+    inline bool empty() const{ return entries.empty(); }
+
+    /// Add val at index
+    inline void add( size_t index, T val ){
+        entries.push_back( std::make_pair( index, val ) );
+    }
+
+    /// Add values to `reports` (indexed as in add()) and clear this buffer
+    void mergeInto( std::vector<T>& reports ){
+        for( const std::pair<size_t, T>& entry : entries ){
+            assert( entry.first < reports.size() );
+            reports[entry.first] += entry.second;
+        }
+        entries.clear();    // keeps capacity for the next step
+    }
+
+private:
+    std::vector<std::pair<size_t, T>> entries;
+};
+
+}
+}
+#endif
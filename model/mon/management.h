@@ -51,17 +51,58 @@ void initMainSim();
 /// Call after all data for some survey number has been provided
 void concludeSurvey();
 
-/// Write survey data to output.txt (or configured file)
+/** With streaming output (CommandLine::STREAM_OUTPUT), append to the output
+ * file all surveys dated before `date` and not yet written, and free their
+ * memory. The caller must ensure that these surveys will not receive further
+ * reports. Does nothing otherwise. */
+void writeConcludedSurveys( SimTime date );
+
+/// Write survey data to output.txt (or configured file); with streaming
+/// output, write remaining surveys and close the file.
 void writeSurveyData();
 
+/** Report buffers, for updating humans in parallel.
+ *
+ * Normally all reports are added directly to the (global) survey stores.
+ * With n > 0 buffers, a thread may instead direct its reports to one buffer
+ * (useReportBuffer()); buffers record each report and are added to the
+ * stores, buffer by buffer in the order reported, by mergeReportBuffers().
+ * Results therefore depend only on which reports go to which buffer, not on
+ * thread timing. If each buffer takes a contiguous block of the reports that
+ * would otherwise be made in sequence, results are identical to unbuffered
+ * reporting. Call after initReporting(), outside of parallel sections. */
+void setReportBuffers( size_t n );
+/// Direct reports made by the calling thread to buffer i (i < n)
+void useReportBuffer( size_t i );
+/// Direct reports made by the calling thread to the stores (the default)
+void useReportStores();
+/** Add all buffers to the stores, in order, and clear them. Call from a
+ * single thread, after useReportStores(), at the end of each step. */
+void mergeReportBuffers();
+
 // Checkpointing
 void checkpoint( std::ostream& stream );
 void checkpoint( std::istream& stream );
 
 // Functions for internal use (within mon package)
 namespace internal{
-    // Write results to stream
+    // Write results to stream (header, all surveys, IMR and end marker)
     void write( std::ostream& stream );
+    // Write results of one survey to stream
+    void writeSurvey( std::ostream& stream, size_t survey );
+    // Write the infant mortality rate, if reported
+    void writeIMR( std::ostream& stream );
+    // Write the file header/end marker (binary output only)
+    void writeHeader( std::ostream& stream );
+    void writeEnd( std::ostream& stream );
+    
+    // Streaming output: make sure stores hold all surveys before `end`
+    void holdSurveys( size_t end );
+    // Streaming output: drop the first held survey from stores
+    void releaseSurvey();
+    // Streaming output: checkpoint position in output file
+    void checkpointOutput( std::ostream& stream );
+    void checkpointOutput( std::istream& stream );
     
     /** Get the output cohort set numeric identifier given the internal one
      * (as returned by Survey::updateCohortSet()). */
@@ -33,6 +33,7 @@
 
 #include <gzstream/gzstream.h>
 #include <fstream>
+#include <filesystem>
 
 namespace OM {
 namespace mon {
@@ -59,6 +60,36 @@ namespace impl{
 
 void updateConditions();        // defined in mon.cpp
 
+// Streaming output (CommandLine::STREAM_OUTPUT):
+namespace stream_out {
+    ofstream stream;
+    // Position in the output file after the last survey written. As in
+    // Continuous, we checkpoint an offset rather than a streampos.
+    streamoff streamOff = 0;
+    size_t nWritten = 0;        // number of reported surveys written
+    vector<SimTime> dates;      // date of each reported survey
+    
+    inline bool enabled(){
+        return util::CommandLine::option( util::CommandLine::STREAM_OUTPUT );
+    }
+    
+    // Let stores allocate every survey which may currently receive reports
+    void holdOpenSurveys(){
+        // survNumStat is never greater than survNumEvent (unless NOT_USED)
+        if( impl::survNumEvent != NOT_USED )
+            internal::holdSurveys( impl::survNumEvent + 1 );
+    }
+    
+    void writeUntil( size_t end ){
+        for( ; nWritten < end; ++nWritten ){
+            internal::writeSurvey( stream, nWritten );
+            internal::releaseSurvey();
+        }
+        stream.flush();
+        streamOff = stream.tellp();
+    }
+}
+
 // trim from start (in place)
 static inline void ltrim(std::string &s) {
     s.erase(s.begin(), std::find_if(s.begin(), s.end(), [](unsigned char ch) {
@@ -123,12 +154,14 @@ SimTime readSurveyDates( const scnXml::Monitoring& monitoring ){
     
     impl::surveyDates.clear();
     impl::surveyDates.reserve(surveys.size());
+    stream_out::dates.clear();
     size_t n = 0;
     for( auto it = surveys.begin(); it != surveys.end(); ++it ){
         size_t num = NOT_USED;
         if( it->second ){
             num = n;
             n += 1;
+            stream_out::dates.push_back(it->first);
         }
         impl::surveyDates.push_back(SurveyDate(it->first, num));
     }
@@ -184,11 +217,37 @@ void initMainSim(){
     impl::surveyIndex = 0;
     impl::isInit = true;
     updateSurveyNumbers();
+    
+    if( stream_out::enabled() ){
+        string filename = util::CommandLine::getOutputName();
+        stream_out::stream.open( filename, std::ios::out | std::ios::binary );
+        if( stream_out::stream.fail() )
+            throw util::base_exception( "unable to open output file: " + filename, util::Error::FileIO );
+        stream_out::stream.width (0);
+        internal::writeHeader( stream_out::stream );
+        stream_out::nWritten = 0;
+        stream_out::streamOff = stream_out::stream.tellp();
+        stream_out::holdOpenSurveys();
+    }
 }
 void concludeSurvey(){
+    mergeReportBuffers();       // normally already done at the end of the step
     updateConditions();
     impl::surveyIndex += 1;
     updateSurveyNumbers();
+    
+    if( stream_out::enabled() )
+        stream_out::holdOpenSurveys();
+}
+void writeConcludedSurveys( SimTime date ){
+    if( !stream_out::enabled() ) return;
+    size_t end = stream_out::nWritten;
+    // Only surveys already concluded (those before survNumEvent) are complete
+    while( end < impl::nSurveys && end < impl::survNumEvent &&
+            stream_out::dates[end] < date )
+        end += 1;
+    if( end > stream_out::nWritten )
+        stream_out::writeUntil( end );
 }
 
 void writeToStream(ostream& stream) {
@@ -205,7 +264,13 @@ void writeSurveyData ()
     string filename = util::CommandLine::getOutputName();
     auto mode = std::ios::out | std::ios::binary;
     
-    if (util::CommandLine::option( util::CommandLine::COMPRESS_OUTPUT )) {
+    if( stream_out::enabled() ){
+        stream_out::writeUntil( impl::nSurveys );
+        internal::writeIMR( stream_out::stream );
+        internal::writeEnd( stream_out::stream );
+        stream_out::stream.flush();
+        stream_out::stream.close();
+    } else if (util::CommandLine::option( util::CommandLine::COMPRESS_OUTPUT )) {
         filename.append(".gz");
         ogzstream stream(filename.c_str(), mode);
         writeToStream(stream);
@@ -224,6 +289,36 @@ void writeSurveyData ()
     }
 }
 
+void internal::checkpointOutput( ostream& stream ){
+    if( !stream_out::enabled() ) return;
+    // On resume, the file is truncated to streamOff: everything before it
+    // must be on disk.
+    stream_out::stream.flush();
+    if( stream_out::stream.fail() )
+        throw util::base_exception( "unable to write output file", util::Error::FileIO );
+    stream_out::nWritten & stream;
+    stream_out::streamOff & stream;
+}
+void internal::checkpointOutput( istream& stream ){
+    if( !stream_out::enabled() ) return;
+    stream_out::nWritten & stream;
+    stream_out::streamOff & stream;
+    if( !impl::isInit ) return; // file is opened by initMainSim()
+    
+    // Resume writing after the last survey written before the checkpoint,
+    // discarding anything written after it.
+    string filename = util::CommandLine::getOutputName();
+    std::error_code ec;
+    std::filesystem::resize_file( filename, stream_out::streamOff, ec );
+    if( ec )
+        throw util::checkpoint_error( "mon: resume error (no output file)" );
+    stream_out::stream.open( filename, std::ios::in | std::ios::out | std::ios::binary );
+    stream_out::stream.seekp( stream_out::streamOff, std::ios_base::beg );
+    if( stream_out::stream.fail() )
+        throw util::checkpoint_error( "mon: resume error (bad pos/file)" );
+    stream_out::stream.width (0);
+}
+
 
 // ———  AgeGroup  ———
 
@@ -255,7 +350,9 @@ void AgeGroup::update (SimTime age) {
 
 using interventions::ComponentId;
 vector<uint32_t> cohortSubPopNumbers;   // value is output number
-map<ComponentId,uint32_t> cohortSubPopIds;      // value is internal index (used above)
+// Internal index (used above) by component id; NOT_USED for sub-populations
+// not used in cohorts
+vector<size_t> cohortSubPopIds;
 
 bool notPowerOfTwo( uint32_t num ){
     for( uint32_t i = 0; i <= 21; ++i ){
@@ -274,8 +371,9 @@ void initCohorts( const scnXml::Monitoring& monitoring )
             end = monCohorts.getSubPop().end(); it != end; ++it )
         {
             ComponentId compId = interventions::InterventionManager::getComponentId( it->getId() );
-            bool inserted = cohortSubPopIds.insert( make_pair(compId,nextId) ).second;
-            if( !inserted ){
+            if( compId.id >= cohortSubPopIds.size() )
+                cohortSubPopIds.resize( compId.id + 1, NOT_USED );
+            if( cohortSubPopIds[compId.id] != NOT_USED ){
                 throw util::xml_scenario_error(
                     string("cohort specification uses sub-population \"").append(it->getId())
                     .append("\" more than once") );
@@ -285,6 +383,7 @@ void initCohorts( const scnXml::Monitoring& monitoring )
                     string( "cohort specification assigns sub-population \"").append(it->getId())
                     .append("\" a number which is not a power of 2 (up to 2^21)") );
             }
+            cohortSubPopIds[compId.id] = nextId;
             cohortSubPopNumbers.push_back( it->getNumber() );
             nextId += 1;
         }
@@ -292,9 +391,9 @@ void initCohorts( const scnXml::Monitoring& monitoring )
 }
 
 uint32_t updateCohortSet( uint32_t old, ComponentId subPop, bool isMember ){
-    auto it = cohortSubPopIds.find( subPop );
-    if( it == cohortSubPopIds.end() ) return old;       // sub-pop not used in cohorts
-    uint32_t subPopId = static_cast<uint32_t>(1) << it->second;        // 1 bit positive
+    if( subPop.id >= cohortSubPopIds.size() ||
+        cohortSubPopIds[subPop.id] == NOT_USED ) return old;       // sub-pop not used in cohorts
+    uint32_t subPopId = static_cast<uint32_t>(1) << cohortSubPopIds[subPop.id];        // 1 bit positive
     return (old & ~subPopId) | (isMember ? subPopId : 0);
 }
 
@@ -24,11 +24,15 @@
 #include "mon/management.h"
 #define H_OM_mon_cpp
 #include "mon/OutputMeasures.h"
+#include "mon/BinaryOutput.h"
+#include "mon/ReportBuffer.h"
 #include "Host/WithinHost/Diagnostic.h"
 #include "Host/WithinHost/Genotypes.h"
 #include "Clinical/ClinicalModel.h"
 #include "Host/Human.h"
 #include "util/errors.h"
+#include "util/CommandLine.h"
+#include "util/TextOutput.h"
 #include "schema/scenario.h"
 
 #include <typeinfo>
@@ -75,11 +79,18 @@ struct MonIndex {
     // Either Deploy::NA (not tracking deployments) or a binary 'or' of at
     // least one of Deploy::TIMED, Deploy::CTS, Deploy::TREAT.
     uint8_t deployMask;
+    // False when the measure can never be reported in this scenario (see
+    // initReporting): no space is allocated and zeros are written.
+    bool stored;
     
     // Used to calculate next offset. This is max output of `index(...)` + 1.
     inline size_t size() const{
         return nAges * nCohorts * nSpecies * nGenotypes * nDrugs;
     }
+    // Number of values held in the result array per survey
+    inline size_t storedSize() const{
+        return stored ? size() : 0;
+    }
     // Get the index in the result array to store this data at
     // (age group, cohort, species, genotype, drug).
     // 
@@ -110,17 +121,22 @@ struct MonIndex {
             (a % nAges))));
     }
     
-    // Write out some data from results.
+    // Categories of one output value, numbered as in the output.
+    struct Cell {
+        uint32_t ageGroup, cohort, species, genotype, drug;
+    };
+    
+    // Call f(cell, value) for each output value of some survey, in output order.
     // 
-    // @param stream Data sink
-    // @param surveyNum Number to write in output (should start from 1 unlike in code)
     // @param results Vector of results
     // @param surveyStart Index in results where data for the current survey starts
-    template<typename T>
-    void write( ostream& stream, int surveyNum, const OutMeasure& om,
-            const vector<T>& results, size_t surveyStart ) const
+    template<typename T, typename F>
+    void forEachValue( const OutMeasure& om, const vector<T>& results,
+            size_t surveyStart, F f ) const
     {
-        assert(results.size() >= surveyStart + size());
+        assert(results.size() >= surveyStart + storedSize());
+        // Value at index i, or zero when not stored
+        auto at = [&]( size_t i ){ return stored ? results[surveyStart + i] : T(0); };
         // First age group starts at 1, unless there isn't an age group:
         const int ageGroupAdd = om.byAge ? 1 : 0;
         // Number of *reported* age categories: either no categorisation (1) or there is an extra unreported category
@@ -129,11 +145,8 @@ struct MonIndex {
             assert( nAges == 1 && nCohorts == 1 && nDrugs == 1 );
             for( size_t species = 0; species < nSpecies; ++species ){
             for( size_t genotype = 0; genotype < nGenotypes; ++genotype ){
-                const int col2 = species + 1 +
-                    1000000 * genotype;
-                T value = results[surveyStart + index(0, 0, species, genotype, 0)];
-                stream << surveyNum << '\t' << col2 << '\t' << om.outId
-                    << '\t' << value << lineEnd;
+                Cell cell = { 0, 0, uint32_t(species + 1), uint32_t(genotype), 0 };
+                f( cell, at( index(0, 0, species, genotype, 0) ) );
             } }
         }else if( om.byDrug ){
             assert( nSpecies == 1 && nGenotypes == 1 );
@@ -141,13 +154,9 @@ struct MonIndex {
             // Last age category is not reported
             for( size_t ageGroup = 0; ageGroup < nAgeCats; ++ageGroup ){
             for( size_t drug = 0; drug < nDrugs; ++drug ){
-                // Yeah, >999 age groups clashes with cohort sets, but unlikely a real issue
-                const int col2 = ageGroup + ageGroupAdd +
-                    1000 * internal::cohortSetOutputId( cohortSet ) +
-                    1000000 * (drug + 1);
-                T value = results[surveyStart + index(ageGroup, cohortSet, 0, 0, drug)];
-                stream << surveyNum << '\t' << col2 << '\t' << om.outId
-                    << '\t' << value << lineEnd;
+                Cell cell = { uint32_t(ageGroup + ageGroupAdd),
+                    internal::cohortSetOutputId( cohortSet ), 0, 0, uint32_t(drug + 1) };
+                f( cell, at( index(ageGroup, cohortSet, 0, 0, drug) ) );
             } } }
         }else{
             assert( nSpecies == 1 && nDrugs == 1 );
@@ -155,16 +164,44 @@ struct MonIndex {
             // Last age category is not reported
             for( size_t ageGroup = 0; ageGroup < nAgeCats; ++ageGroup ){
             for( size_t genotype = 0; genotype < nGenotypes; ++genotype ){
-                // Yeah, >999 age groups clashes with cohort sets, but unlikely a real issue
-                const int col2 = ageGroup + ageGroupAdd +
-                    1000 * internal::cohortSetOutputId( cohortSet ) +
-                    1000000 * genotype;
-                T value = results[surveyStart + index(ageGroup, cohortSet, 0, genotype, 0)];
-                stream << surveyNum << '\t' << col2 << '\t' << om.outId
-                    << '\t' << value << lineEnd;
+                Cell cell = { uint32_t(ageGroup + ageGroupAdd),
+                    internal::cohortSetOutputId( cohortSet ), 0, uint32_t(genotype), 0 };
+                f( cell, at( index(ageGroup, cohortSet, 0, genotype, 0) ) );
             } } }
         }
     }
+    
+    // Write out some data from results.
+    // 
+    // @param stream Data sink
+    // @param surveyNum Number to write in output (should start from 1 unlike in code)
+    // @param results Vector of results
+    // @param surveyStart Index in results where data for the current survey starts
+    template<typename T>
+    void write( util::text::Writer& stream, int surveyNum, const OutMeasure& om,
+            const vector<T>& results, size_t surveyStart ) const
+    {
+        forEachValue( om, results, surveyStart, [&]( const Cell& cell, T value ){
+            // Only categories used by this measure are non-zero.
+            // Yeah, >999 age groups clashes with cohort sets, but unlikely a real issue
+            const int col2 = cell.ageGroup + cell.species +
+                1000 * cell.cohort +
+                1000000 * (cell.genotype + cell.drug);
+            stream << surveyNum << '\t' << col2 << '\t' << om.outId
+                << '\t' << value << lineEnd;
+        } );
+    }
+    
+    // As write(), but append rows to binary output columns.
+    template<typename T>
+    void writeColumns( binary::Columns& cols, int surveyNum, const OutMeasure& om,
+            const vector<T>& results, size_t surveyStart ) const
+    {
+        forEachValue( om, results, surveyStart, [&]( const Cell& cell, T value ){
+            cols.push( surveyNum, cell.ageGroup, cell.cohort, cell.species,
+                    cell.genotype, cell.drug, om.outId, value );
+        } );
+    }
 };
 
 struct MonIndByMeasure{
@@ -174,11 +211,15 @@ struct MonIndByMeasure{
     }
 } monIndByMeasure;
 
+// Report buffer used by this thread (see setReportBuffers()), or NOT_USED
+// to add reports directly to the stores.
+static thread_local size_t reportBuffer = NOT_USED;
+
 // Store data of type T which is to be reported
 template<typename T>
 class Store{
 public:
-    Store() : surveySize(0) {}
+    Store() : surveySize(0), firstSurvey(0), nHeld(0) {}
     
 private:
     // This lists all enabled outputs, sorted by `measure` (first field, of
@@ -191,19 +232,32 @@ private:
     typedef pair<uint16_t, uint16_t> MeasureRange;
     vector<MeasureRange> measure_map;
     
+    // For each measure, whether any values of it are stored
+    vector<bool> measureStored;
+    
     // Number of indices in `reports` used by a single survey
     size_t surveySize;
+    // Surveys held in `reports`: nHeld surveys starting from firstSurvey.
+    // Normally this is all surveys; with streaming output, surveys are
+    // added when they may receive reports and removed once written.
+    size_t firstSurvey, nHeld;
     // These are the stored reports (multidimensional; size is `size()` and
-    // indices are `survey * surveySize + measures[m].index(...)` for some `m`).
+    // indices are `(survey - firstSurvey) * surveySize + measures[m].index(...)`
+    // for some `m`).
     vector<T> reports;
     
+    // Report buffers, holding (index in `reports`, value) pairs
+    vector<ReportBuffer<T>> buffers;
+    
     // get size of reports
-    inline size_t size(){ return surveySize * impl::nSurveys; }
+    inline size_t size(){ return surveySize * nHeld; }
     
 public:
     // Set up ready to accept reports. The passed list includes all measures
-    // used; we ignore those of the wrong type.
-    void init( const vector<OutMeasure>& enabledMeasures, size_t nSp, size_t nD ){
+    // used; we ignore those of the wrong type. Measures in `unreachable` get
+    // no storage.
+    void init( const vector<OutMeasure>& enabledMeasures,
+            const set<Measure>& unreachable, size_t nSp, size_t nD ){
         for( const OutMeasure& om : enabledMeasures ){
             // Two types: double and int. Skip if type is wrong.
             if( om.isDouble != (typeid(T) == typeid(double)) ) continue;
@@ -220,11 +274,15 @@ public:
             m.nGenotypes = om.byGenotype ? WithinHost::Genotypes::N() : 1;
             m.nDrugs = om.byDrug ? nD : 1;
             m.deployMask = om.method;
+            m.stored = unreachable.count(om.m) == 0;
             measures.push_back(m);
         }
         
         sortEnabledMeasures();
         
+        // With streaming output, surveys are only allocated by hold()
+        if( !util::CommandLine::option( util::CommandLine::STREAM_OUTPUT ) )
+            nHeld = impl::nSurveys;
         // Leave a few spare slots for potential conditions using variables not already reported:
         reports.reserve(size() + 12);
         reports.assign(size(), 0);
@@ -260,6 +318,7 @@ public:
         m.nGenotypes = 1;
         m.nDrugs = 1;
         m.deployMask = om.method;
+        m.stored = true;
         measures.push_back(m);
         
         sortEnabledMeasures();
@@ -267,13 +326,14 @@ public:
     }
     
     // Sort measures, then fix the offsets and surveySize, then set measure_map
+    // and measureStored
     void sortEnabledMeasures() {
         std::sort( measures.begin(), measures.end(), monIndByMeasure );
         measure_map.assign(M_NUM, make_pair(0, 0));
         surveySize = 0;
         for( size_t i = 0; i < measures.size(); ++i ){
             measures[i].offset = surveySize;
-            surveySize += measures[i].size();
+            surveySize += measures[i].storedSize();
             
             Measure m = measures[i].measure;
 
@@ -283,6 +343,22 @@ public:
                 measure_map[m].first = i;
             measure_map[m].second = i + 1;
         }
+        
+        measureStored.assign(M_NUM, false);
+        for( const MonIndex& ind : measures ){
+            if( ind.stored ) measureStored[ind.measure] = true;
+        }
+    }
+    
+    // Add val to index of reports, or of this thread's report buffer if any
+    inline void add( size_t index, T val ){
+        if( reportBuffer == NOT_USED ){
+            assert( index < reports.size() );
+            reports[index] += val;
+        }else{
+            assert( reportBuffer < buffers.size() );
+            buffers[reportBuffer].add( index, val );
+        }
     }
     
     // Take a reported value and either store it or forget it.
@@ -300,10 +376,10 @@ public:
             assert(ind.measure == measure);
             if( ind.deployMask != Deploy::NA ) continue;        // skip measures tracking deployments
             if( outId != 0 && ind.outMeasure != outId) continue;     // skip if supplied outID is different
-            size_t index = survey * surveySize +
-                    ind.index(ageIndex, cohortSet, species, genotype, drug);
-            assert( index < reports.size() );
-            reports[index] += val;
+            if( !ind.stored ) continue;         // never reported
+            assert( survey >= firstSurvey );
+            add( (survey - firstSurvey) * surveySize +
+                    ind.index(ageIndex, cohortSet, species, genotype, drug), val );
         }
     }
     
@@ -324,12 +400,12 @@ public:
             assert(ind.measure == measure);
             // skip measures not tracking deployments or not tracking this type of deployment
             if( (ind.deployMask & method) == Deploy::NA ) continue;
+            if( !ind.stored ) continue;         // never reported
             assert( ind.nSpecies == 1 && ind.nGenotypes == 1 );     // never used for deployments
             
-            size_t index = survey * surveySize +
-                    ind.index(ageIndex, cohortSet, 0, 0, 0);
-            assert( index < reports.size() );
-            reports[index] += val;
+            assert( survey >= firstSurvey );
+            add( (survey - firstSurvey) * surveySize +
+                    ind.index(ageIndex, cohortSet, 0, 0, 0), val );
         }
     }
     
@@ -349,9 +425,10 @@ public:
             assert(ind.measure == measure);
             if( ind.deployMask != method ) continue;    // incompatible deployment mode: skip
             
-            const size_t off = survey * surveySize + ind.offset;
+            assert( survey >= firstSurvey );
+            const size_t off = (survey - firstSurvey) * surveySize + ind.offset;
             T sum = 0;
-            size_t end2 = off + ind.size();
+            size_t end2 = off + ind.storedSize();
             assert(end2 <= reports.size());
             for( size_t i = off; i < end2; ++i ){
                 sum += reports[i];
@@ -364,34 +441,90 @@ public:
     
     // Return true if reports by this measure are recorded, false if they are discarded.
     bool isUsed( Measure measure ){
-        assert( measure < measure_map.size() );
-        return measure_map[measure].second > measure_map[measure].first;
+        assert( measure < measureStored.size() );
+        return measureStored[measure];
     }
     
     // Write stored values to stream for some output measure, om
-    void write( ostream& stream, size_t survey, const OutMeasure& om ){
+    void write( util::text::Writer& stream, size_t survey, const OutMeasure& om ){
+        assert(om.m < measure_map.size());
+        for( size_t i = measure_map[om.m].first, end = measure_map[om.m].second;
+            i < end; ++i )
+        {
+            assert(i < measures.size());
+            if( measures[i].outMeasure == om.outId ){
+                assert( survey >= firstSurvey );
+                measures[i].write( stream, survey + 1, om, reports,
+                        (survey - firstSurvey) * surveySize );
+                return;
+            }
+        }
+        assert(false && "measure not found in records");
+    }
+    
+    // As write(), but append to binary output columns
+    void writeColumns( binary::Columns& cols, size_t survey, const OutMeasure& om ){
         assert(om.m < measure_map.size());
         for( size_t i = measure_map[om.m].first, end = measure_map[om.m].second;
             i < end; ++i )
         {
             assert(i < measures.size());
             if( measures[i].outMeasure == om.outId ){
-                measures[i].write( stream, survey + 1, om, reports, survey * surveySize );
+                assert( survey >= firstSurvey );
+                measures[i].writeColumns( cols, survey + 1, om, reports,
+                        (survey - firstSurvey) * surveySize );
                 return;
             }
         }
         assert(false && "measure not found in records");
     }
     
-    // Checkpointing
+    // Streaming output: make sure all surveys before `end` are held.
+    void hold( size_t end ){
+        if( end > firstSurvey + nHeld ){
+            nHeld = end - firstSurvey;
+            reports.resize( size(), 0 );
+        }
+    }
+    
+    // Streaming output: drop the first held survey (once written).
+    void release(){
+        assert( nHeld > 0 );
+        reports.erase( reports.begin(), reports.begin() + surveySize );
+        firstSurvey += 1;
+        nHeld -= 1;
+    }
+    
+    // Use n report buffers. Existing buffers must be empty.
+    void setBuffers( size_t n ){
+        for( const ReportBuffer<T>& b : buffers ) assert( b.empty() );
+        buffers.assign( n, ReportBuffer<T>() );
+    }
+    
+    // Add buffers to reports, in buffer order, and clear them.
+    void mergeBuffers(){
+        for( ReportBuffer<T>& b : buffers )
+            b.mergeInto( reports );
+    }
+    
+    // Checkpointing (buffers are merged at the end of each step, thus empty)
     void checkpoint( ostream& stream ){
+        for( const ReportBuffer<T>& b : buffers ) assert( b.empty() );
+        if( util::CommandLine::option( util::CommandLine::STREAM_OUTPUT ) ){
+            firstSurvey & stream;
+            nHeld & stream;
+        }
         reports.size() & stream;
         for (T& y : reports) {
             y & stream;
         }
-        // reports is the only field which changes after initialisation
+        // other fields are set by initialisation
     }
     void checkpoint( istream& stream ){
+        if( util::CommandLine::option( util::CommandLine::STREAM_OUTPUT ) ){
+            firstSurvey & stream;
+            nHeld & stream;
+        }
         size_t l;
         l & stream;
         if( l != size() ){
@@ -401,17 +534,72 @@ public:
         for (T& y : reports) {
             y & stream;
         }
-        // reports is the only field which changes after initialisation
+        // other fields are set by initialisation
     }
 };
 
 // Enabled measures:
 vector<OutMeasure> reportedMeasures;
+// Names of enabled measures, by output number (for binary output):
+map<int,string> reportedNames;
 // Stores of reported data by two different types:
 Store<int> storeI;
 Store<double> storeF;
 int reportIMR = -1; // special output for fitting
 
+// If measure m can never be reported in this scenario, return the reason;
+// otherwise return nullptr. Only components which are fixed by the scenario
+// document are considered.
+const char* unreachableReason( Measure m, const scnXml::Scenario& scenario ){
+    switch( m ){
+        case MHR_HOSTS_POS_DRUG_CONC:
+        case MHF_LOG_DRUG_CONC:
+            // Only reported by the PK/PD model, for drugs in use
+            if( !scenario.getPharmacology().present() )
+                return "no pharmacology data";
+            return nullptr;
+        case MVF_LAST_NV0:
+        case MVF_LAST_NV:
+        case MVF_LAST_OV:
+        case MVF_LAST_SV:
+            // Only reported by the Anopheles model
+            if( !scenario.getEntomology().getVector().present() )
+                return "no vector entomology data";
+            return nullptr;
+        case MHD_VACCINATIONS: case MHD_PEV: case MHD_BSV: case MHD_TBV:
+        case MHD_ITN: case MHD_IRS: case MHD_GVI:
+            break;      // depends on interventions: see below
+        default:
+            return nullptr;
+    }
+    
+    // Deployment measures for components of one type
+    bool pev = false, bsv = false, tbv = false, itn = false, irs = false, gvi = false;
+    const scnXml::Interventions& intervElt = scenario.getInterventions();
+    if( intervElt.getHuman().present() ){
+        for( const scnXml::HumanInterventionComponent& component :
+                intervElt.getHuman().get().getComponent() )
+        {
+            pev = pev || component.getPEV().present();
+            bsv = bsv || component.getBSV().present();
+            tbv = tbv || component.getTBV().present();
+            itn = itn || component.getITN().present();
+            irs = irs || component.getIRS().present();
+            gvi = gvi || component.getGVI().present();
+        }
+    }
+    switch( m ){
+        case MHD_VACCINATIONS: return pev || bsv || tbv ? nullptr : "no vaccine components";
+        case MHD_PEV: return pev ? nullptr : "no PEV components";
+        case MHD_BSV: return bsv ? nullptr : "no BSV components";
+        case MHD_TBV: return tbv ? nullptr : "no TBV components";
+        case MHD_ITN: return itn ? nullptr : "no ITN components";
+        case MHD_IRS: return irs ? nullptr : "no IRS components";
+        case MHD_GVI: return gvi ? nullptr : "no GVI components";
+        default: throw SWITCH_DEFAULT_EXCEPTION;
+    }
+}
+
 struct MeasureByOutId{
     bool operator() (const OutMeasure& i,const OutMeasure& j) {
         return i.outId < j.outId;
@@ -500,6 +688,7 @@ void initReporting( const scnXml::Scenario& scenario ){
         outIds.insert( om.outId );
         
         reportedMeasures.push_back( om );
+        reportedNames[om.outId] = optElt.getName();
     }
     
     std::sort( reportedMeasures.begin(), reportedMeasures.end(), measureByOutId );
@@ -509,8 +698,21 @@ void initReporting( const scnXml::Scenario& scenario ){
     size_t nDrugs = scenario.getPharmacology().present() ?
         scenario.getPharmacology().get().getDrugs().getDrug().size() : 1;
     
-    storeI.init( reportedMeasures, nSpecies, nDrugs );
-    storeF.init( reportedMeasures, nSpecies, nDrugs );
+    // Measures which cannot be reported are still written (as zeros), but
+    // are not given storage.
+    set<Measure> unreachable;
+    for( const OutMeasure& om : reportedMeasures ){
+        if( om.m >= M_NUM ) continue;
+        const char* reason = unreachableReason( om.m, scenario );
+        if( reason == nullptr ) continue;
+        unreachable.insert( om.m );
+        cerr << "Warning: survey option " << reportedNames[om.outId]
+            << " can never be reported in this scenario (" << reason
+            << "); it will be output as zero." << endl;
+    }
+    
+    storeI.init( reportedMeasures, unreachable, nSpecies, nDrugs );
+    storeF.init( reportedMeasures, unreachable, nSpecies, nDrugs );
 }
 
 size_t setupCondition( const string& measureName, double minValue,
@@ -553,25 +755,65 @@ bool checkCondition( size_t conditionKey ){
     return impl::conditions[conditionKey].value;
 }
 
+inline bool binaryOutput(){
+    return util::CommandLine::option( util::CommandLine::BINARY_OUTPUT );
+}
+
 void internal::write( ostream& stream ){
+    writeHeader( stream );
     for( size_t survey = 0; survey < impl::nSurveys; ++survey ){
+        writeSurvey( stream, survey );
+    }
+    writeIMR( stream );
+    writeEnd( stream );
+}
+void internal::writeHeader( ostream& stream ){
+    if( !binaryOutput() ) return;
+    vector<binary::MeasureInfo> measures;
+    for( const OutMeasure& om : reportedMeasures ){
+        measures.push_back( binary::MeasureInfo{ om.outId, om.isDouble, reportedNames[om.outId] } );
+    }
+    binary::writeHeader( stream, measures );
+}
+void internal::writeEnd( ostream& stream ){
+    if( binaryOutput() ) binary::writeEnd( stream );
+}
+void internal::writeSurvey( ostream& stream, size_t survey ){
+    if( binaryOutput() ){
+        static binary::Columns cols;    // reused to avoid reallocation
+        cols.clear();
         for( const OutMeasure& om : reportedMeasures ){
-            if( om.m >= M_NUM ){
-                // "Special" measures are not reported this way. The only such measure is IMR.
-                assert( om.m == M_ALL_CAUSE_IMR && reportIMR >= 0 );
-                continue;
-            } else if( om.isDouble ) {
-                storeF.write( stream, survey, om );
-            } else {
-                storeI.write( stream, survey, om );
-            }
+            if( om.m >= M_NUM ) continue;       // IMR: see writeIMR
+            else if( om.isDouble ) storeF.writeColumns( cols, survey, om );
+            else storeI.writeColumns( cols, survey, om );
+        }
+        binary::writeBlock( stream, cols );
+        return;
+    }
+    util::text::Writer out( stream );
+    for( const OutMeasure& om : reportedMeasures ){
+        if( om.m >= M_NUM ){
+            // "Special" measures are not reported this way. The only such measure is IMR.
+            assert( om.m == M_ALL_CAUSE_IMR && reportIMR >= 0 );
+            continue;
+        } else if( om.isDouble ) {
+            storeF.write( out, survey, om );
+        } else {
+            storeI.write( out, survey, om );
         }
     }
-    if( reportIMR >= 0 ){
+}
+void internal::writeIMR( ostream& stream ){
+    if( reportIMR >= 0 && binaryOutput() ){
+        binary::Columns cols;
+        cols.push( 1, 1, 0, 0, 0, 0, reportIMR, Clinical::InfantMortality::allCause() );
+        binary::writeBlock( stream, cols );
+    } else if( reportIMR >= 0 ){
         // Infant mortality rate is a single number, therefore treated specially.
         // It is calculated across the entire intervention period and used in
         // model fitting.
-        stream << 1 << "\t" << 1 << "\t" << reportIMR
+        util::text::Writer out( stream );
+        out << 1 << "\t" << 1 << "\t" << reportIMR
             << "\t" << Clinical::InfantMortality::allCause() << lineEnd;
     }
 }
@@ -673,6 +915,44 @@ bool isUsedM( Measure measure ){
     return storeI.isUsed(measure) || storeF.isUsed(measure);
 }
 
+HostSummary::HostSummary( const Host::Human& human ) :
+    survey( impl::survNumStat ),
+    ageIndex( human.monitoringAgeGroup.i() ),
+    cohortSet( human.getCohortSet() )
+{}
+void HostSummary::addI( Measure measure, size_t genotype, size_t drug, int val ){
+    storeI.report( val, measure, survey, ageIndex, cohortSet, 0, genotype, drug );
+}
+void HostSummary::addF( Measure measure, size_t genotype, size_t drug, double val ){
+    storeF.report( val, measure, survey, ageIndex, cohortSet, 0, genotype, drug );
+}
+
+void setReportBuffers( size_t n ){
+    assert( reportBuffer == NOT_USED );
+    storeI.setBuffers( n );
+    storeF.setBuffers( n );
+}
+void useReportBuffer( size_t i ){
+    reportBuffer = i;
+}
+void useReportStores(){
+    reportBuffer = NOT_USED;
+}
+void mergeReportBuffers(){
+    assert( reportBuffer == NOT_USED );
+    storeI.mergeBuffers();
+    storeF.mergeBuffers();
+}
+
+void internal::holdSurveys( size_t end ){
+    storeI.hold( end );
+    storeF.hold( end );
+}
+void internal::releaseSurvey(){
+    storeI.release();
+    storeF.release();
+}
+
 void checkpoint( ostream& stream ){
     impl::isInit & stream;
     impl::surveyIndex & stream;
@@ -682,6 +962,7 @@ void checkpoint( ostream& stream ){
     
     storeI.checkpoint(stream);
     storeF.checkpoint(stream);
+    internal::checkpointOutput(stream);
 }
 void checkpoint( istream& stream ){
     impl::isInit & stream;
@@ -692,6 +973,7 @@ void checkpoint( istream& stream ){
     
     storeI.checkpoint(stream);
     storeF.checkpoint(stream);
+    internal::checkpointOutput(stream);
 }
 
 }
@@ -257,6 +257,45 @@ void reportStatMACSGF( Measure measure, size_t ageIndex, uint32_t cohortSet,
 /// This function is not fast, so it is recommended to cache the result.
 bool isUsedM( Measure measure );
 
+/** Survey-time ('Stat') reports for one human, used by Host::summarize.
+ *
+ * The survey number, age group and cohort set are looked up once; each
+ * report is added to the stores immediately. */
+class HostSummary {
+public:
+    explicit HostSummary( const Host::Human& human );
+    HostSummary( const HostSummary& ) = delete;
+    HostSummary& operator=( const HostSummary& ) = delete;
+    
+    /// As reportStatMHI
+    inline void reportI( Measure measure, int val ){ addI( measure, 0, 0, val ); }
+    /// As reportStatMHGI
+    inline void reportGI( Measure measure, size_t genotype, int val ){
+        addI( measure, genotype, 0, val );
+    }
+    /// As reportStatMHPI
+    inline void reportPI( Measure measure, size_t drug, int val ){
+        addI( measure, 0, drug, val );
+    }
+    /// As reportStatMHF
+    inline void reportF( Measure measure, double val ){ addF( measure, 0, 0, val ); }
+    /// As reportStatMHGF
+    inline void reportGF( Measure measure, size_t genotype, double val ){
+        addF( measure, genotype, 0, val );
+    }
+    /// As reportStatMHPF
+    inline void reportPF( Measure measure, size_t drug, double val ){
+        addF( measure, 0, drug, val );
+    }
+    
+private:
+    void addI( Measure measure, size_t genotype, size_t drug, int val );
+    void addF( Measure measure, size_t genotype, size_t drug, double val );
+    
+    size_t survey, ageIndex;
+    uint32_t cohortSet;
+};
+
 }
 }
 #endif
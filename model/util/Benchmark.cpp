@@ -0,0 +1,120 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2022 University of Basel
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+#include "util/Benchmark.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+
+namespace OM { namespace util { namespace benchmark {
+
+bool enabled = false;
+
+namespace {
+    struct SectionData {
+        double seconds = 0.0;
+        uint64_t calls = 0;
+        uint64_t allocations = 0;
+        uint64_t items = 0;
+    };
+    SectionData sections[NUM_SECTIONS];
+    
+    const char* sectionNames[NUM_SECTIONS] = {
+        "human update",
+        "survey",
+        "continuous output",
+        "transmission",
+        "output"
+    };
+    
+    std::atomic<uint64_t> allocationCount(0);
+}
+
+void init(){
+    enabled = true;
+}
+
+bool countsAllocations(){
+#ifdef OM_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint64_t allocations(){
+    return allocationCount.load( std::memory_order_relaxed );
+}
+
+void record( Section section, double seconds, uint64_t allocations, uint64_t items ){
+    SectionData& data = sections[section];
+    data.seconds += seconds;
+    data.calls += 1;
+    data.allocations += allocations;
+    data.items += items;
+}
+
+void report( std::ostream& stream ){
+    if( !enabled ) return;
+    stream << "Benchmark:" << std::endl;
+    stream << std::left << std::setw(20) << "section" << std::right
+        << std::setw(12) << "seconds" << std::setw(12) << "calls"
+        << std::setw(14) << "items" << std::setw(14) << "ns/item";
+    if( countsAllocations() )
+        stream << std::setw(14) << "allocations" << std::setw(12) << "allocs/item";
+    stream << std::endl;
+    for( size_t i = 0; i < NUM_SECTIONS; ++i ){
+        const SectionData& data = sections[i];
+        if( data.calls == 0 ) continue;
+        const double perItem = data.items > 0 ? 1.0 / data.items : 0.0;
+        stream << std::left << std::setw(20) << sectionNames[i] << std::right
+            << std::fixed << std::setprecision(3) << std::setw(12) << data.seconds
+            << std::setw(12) << data.calls << std::setw(14) << data.items
+            << std::setprecision(1) << std::setw(14) << data.seconds * 1e9 * perItem;
+        if( countsAllocations() )
+            stream << std::setw(14) << data.allocations
+                << std::setprecision(4) << std::setw(12) << data.allocations * perItem;
+        stream << std::endl;
+    }
+    stream << std::defaultfloat;
+}
+
+} } }
+
+#ifdef OM_COUNT_ALLOCATIONS
+// Replacement global allocation functions, counting each allocation. The
+// array and nothrow forms forward to these in the standard library.
+void* operator new( std::size_t size ){
+    OM::util::benchmark::allocationCount.fetch_add( 1, std::memory_order_relaxed );
+    if( size == 0 ) size = 1;
+    if( void* p = std::malloc( size ) ) return p;
+    throw std::bad_alloc();
+}
+void operator delete( void* p ) noexcept {
+    std::free( p );
+}
+void operator delete( void* p, std::size_t ) noexcept {
+    std::free( p );
+}
+#endif
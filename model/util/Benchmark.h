@@ -0,0 +1,103 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2022 University of Basel
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef Hmod_util_Benchmark
+#define Hmod_util_Benchmark
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace OM { namespace util {
+
+/** @brief Light-weight timing and allocation counters.
+ *
+ * Timings are only collected when the --benchmark command-line option is
+ * given; the report is printed to stderr at the end of the run.
+ *
+ * Heap allocations are only counted when the cmake option
+ * OM_COUNT_ALLOCATIONS is enabled (which replaces global operator new); in
+ * other builds allocation counts are always reported as zero. */
+namespace benchmark {
+    /// Sections of the simulation loop which are timed separately
+    enum Section {
+        HUMAN_UPDATE,       ///< Host::update for all humans
+        SURVEY,             ///< Host::summarize and mon::concludeSurvey
+        CONTINUOUS,         ///< Continuous output
+        TRANSMISSION,       ///< vectorUpdate, updateKappa and surveyEIR
+        OUTPUT,             ///< mon::writeSurveyData
+        NUM_SECTIONS
+    };
+    
+    /// True if benchmarking is enabled (set by init()).
+    extern bool enabled;
+    
+    /// Enable benchmarking (call before the simulation starts).
+    void init();
+    
+    /// True if heap allocations are counted in this build.
+    bool countsAllocations();
+    
+    /// Number of heap allocations made by the program so far (0 if not counted).
+    uint64_t allocations();
+    
+    /// Add a measurement to a section.
+    void record( Section section, double seconds, uint64_t allocations, uint64_t items );
+    
+    /** Print all collected measurements. Does nothing if not enabled. */
+    void report( std::ostream& stream );
+    
+    /** Measures the time and allocations of its own lifetime and adds them
+     * to a section. Has almost no cost when benchmarking is not enabled. */
+    class ScopedTimer {
+    public:
+        /** @param items Number of work items (e.g. humans) covered, used
+         * to report per-item costs. */
+        ScopedTimer( Section section, uint64_t items = 1 ) :
+            section(section), items(items), active(enabled)
+        {
+            if( active ){
+                allocs0 = allocations();
+                start = std::chrono::steady_clock::now();
+            }
+        }
+        ~ScopedTimer(){
+            if( active ){
+                std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                record( section, elapsed.count(), allocations() - allocs0, items );
+            }
+        }
+        
+        ScopedTimer( const ScopedTimer& ) = delete;
+        ScopedTimer& operator=( const ScopedTimer& ) = delete;
+        
+    private:
+        Section section;
+        uint64_t items;
+        bool active;
+        uint64_t allocs0 = 0;
+        std::chrono::steady_clock::time_point start;
+    };
+}
+
+} }
+#endif
@@ -24,6 +24,7 @@
 #include "util/errors.h"
 #include "util/StreamValidator.h"
 #include "util/DocumentLoader.h"
+#include "util/TextOutput.h"
 /* if you get compile errors like "version.h not found", run CMake first */
 #include "util/version.h"
 
@@ -37,6 +38,7 @@ namespace OM { namespace util {
 	string CommandLine::outputName;
 	string CommandLine::ctsoutName;
 	string CommandLine::checkpointFileName;
+	size_t CommandLine::reportBuffers = 0;
 
 	string parseNextArg (int argc, char* argv[], int& i) {
 		++i;
@@ -99,6 +101,12 @@ namespace OM { namespace util {
 					outputName = parseNextArg (argc, argv, i);
 				} else if (clo == "compress-output") {
 					options.set (COMPRESS_OUTPUT);
+				} else if (clo == "compress-ctsout") {
+					options.set (COMPRESS_CTSOUT);
+				} else if (clo == "stream-output") {
+					options.set (STREAM_OUTPUT);
+				} else if (clo == "binary-output") {
+					options.set (BINARY_OUTPUT);
 				} else if (clo == "ctsout") {
 					if (ctsoutName != ""){
 						throw cmd_exception ("--ctsout argument may only be given once");
@@ -147,6 +155,30 @@ namespace OM { namespace util {
 					options.set (CHECKPOINT_STOP);
 				} else if (clo == "debug-vector-fitting") {
 					options.set (DEBUG_VECTOR_FITTING);
+				} else if (clo == "benchmark") {
+					options.set (BENCHMARK);
+				} else if (clo == "output-precision") {
+					string arg = parseNextArg (argc, argv, i);
+					size_t end = 0;
+					int digits = -1;
+					try {
+						digits = std::stoi (arg, &end);
+					} catch (const std::exception&) {
+						end = 0;
+					}
+					if (end == 0 || end != arg.size() || digits < 0 || digits > 17)
+						throw cmd_exception ("--output-precision: expected a number from 0 to 17, not " + arg);
+					text::setPrecision (digits);
+				} else if (clo == "report-buffers") {
+					string arg = parseNextArg (argc, argv, i);
+					size_t end = 0;
+					try {
+						reportBuffers = std::stoul (arg, &end);
+					} catch (const std::exception&) {
+						end = 0;
+					}
+					if (end == 0 || end != arg.size())
+						throw cmd_exception ("--report-buffers: expected a number, not " + arg);
 #	ifdef OM_STREAM_VALIDATOR
 				} else if (clo == "stream-validator") {
 					if (sVFile.size())
@@ -236,6 +268,18 @@ namespace OM { namespace util {
 		<< " -n --name NAME		Equivalent to --scenario scenarioNAME.xml --output outputNAME.txt \\"<<endl
 		<< "			--ctsout ctsoutNAME.txt" <<endl
 		<< " -z --compress-output	Compress output with gzip (writes output.txt.gz)." << endl
+		<< "    --compress-ctsout	Compress continuous output with gzip (writes ctsout.txt.gz)." << endl
+		<< "    --stream-output	Write each survey to the output file as soon as it is complete" << endl
+		<< "			instead of at the end, so that memory use does not grow with the" << endl
+		<< "			number of surveys. Output is identical, except that nUncomp_Imported," << endl
+		<< "			_Introduced and _Indigenous use the infection origin when the" << endl
+		<< "			episode expires. Cannot be used with -z." << endl
+		<< "    --binary-output	Write survey output in a binary columnar format, read by" << endl
+		<< "			util/readBinaryOutput.py. If not given, the output file is output.bin." << endl
+		<< "    --output-precision N" << endl
+		<< "			Write floating-point values in output and ctsout files with N" << endl
+		<< "			significant digits (default 6). With 0, write the shortest text" << endl
+		<< "			which reads back as the same value." << endl
 		<< "    --validate-only	Initialise and validate scenario, but don't run simulation." << endl
 		<< "    --no-deprecation-warnings" << endl
 		<< "			OpenMalaria warn about the use of features deemed error-prone and where" << endl
@@ -262,6 +306,12 @@ namespace OM { namespace util {
 		<< "			Show details of vector-parameter fitting. The fitting methods used" <<endl
 		<< "			aren't guaranteed to work. If they don't, this output should help"<<endl
 		<< "			work out why."<<endl
+		<< "    --benchmark	Time sections of the simulation loop and print a summary to" << endl
+		<< "			stderr at the end. Heap allocations are also counted when" << endl
+		<< "			compiled with OM_COUNT_ALLOCATIONS." << endl
+		<< "    --report-buffers N	Split the human update into N blocks which report to separate" << endl
+		<< "			monitoring buffers, merged at the end of each step (as for a" << endl
+		<< "			parallel update). Output is unchanged." << endl
 #	ifdef OM_STREAM_VALIDATOR
 		<< "    --stream-validator PATH" <<endl
 		<< "			Use StreamValidator to validate against reference file PATH." <<endl
@@ -276,6 +326,10 @@ namespace OM { namespace util {
 	if( cloVersion || cloHelp ){
 		throw cmd_exception("Printed help",Error::None);
 	}
+	if( options[STREAM_OUTPUT] && options[COMPRESS_OUTPUT] ){
+		// gzip streams cannot be repositioned when resuming from a checkpoint
+		throw cmd_exception ("--stream-output may not be used along with --compress-output");
+	}
 	
 #	ifdef OM_STREAM_VALIDATOR
 	if( sVFile.size() )
@@ -286,7 +340,7 @@ namespace OM { namespace util {
 		scenarioFile = "scenario.xml";
 	}
 	if (outputName == ""){
-		outputName = "output.txt";
+		outputName = options[BINARY_OUTPUT] ? "output.bin" : "output.txt";
 	}
 	if (ctsoutName == ""){
 		ctsoutName = "ctsout.txt";
@@ -49,6 +49,14 @@ namespace OM { namespace util {
 			SKIP_SIMULATION,
             /** Compress output.txt file. */
 			COMPRESS_OUTPUT,
+            /** Write each survey to output.txt once it can no longer receive
+             * reports, instead of holding all surveys until the end. */
+			STREAM_OUTPUT,
+            /** Compress ctsout.txt file. */
+			COMPRESS_CTSOUT,
+            /** Write survey output in a binary columnar format (see
+             * mon/BinaryOutput.h) instead of text. */
+			BINARY_OUTPUT,
 	    /** Print the annual EIR. */
 			PRINT_ANNUAL_EIR,
             /** Outputs samples from the active interpolation methods of all
@@ -66,6 +74,8 @@ namespace OM { namespace util {
             /** Print times of all surveys. */
 			PRINT_SURVEY_TIMES,
 			PRINT_GENOTYPES,
+            /** Time the main simulation loop and print a summary at the end. */
+			BENCHMARK,
 			NUM_OPTIONS
 		};
 
@@ -87,6 +97,12 @@ namespace OM { namespace util {
 			return ctsoutName;
 		}
 
+     /** Get the number of monitoring report buffers used by the human
+      * update (0: report directly). */
+		static inline size_t getReportBuffers (){
+			return reportBuffers;
+		}
+
      /** Get the name of the checkpoint file. */
 		static inline string getCheckpointName (){
 			return checkpointFileName;
@@ -118,6 +134,7 @@ private:
 	static string outputName;
 	static string ctsoutName;
 	static string checkpointFileName;
+	static size_t reportBuffers;
 };
 } }
 #endif
@@ -0,0 +1,45 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2022 University of Basel
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+#include "util/FastMath.h"
+
+namespace OM {
+namespace util {
+namespace fastmath {
+
+Tables::Tables(){
+    for( int i = 0; i < (1 << LOG2_BITS); ++i ){
+        const double c = 1.0 + (i + 0.5) / (1 << LOG2_BITS);
+        log2Inv[i] = 1.0 / c;
+        // use the rounded inverse, so that m * log2Inv[i] - 1 is consistent:
+        log2Centre[i] = -std::log2( log2Inv[i] );
+    }
+    for( int j = 0; j < (1 << EXP2_BITS); ++j ){
+        exp2Frac[j] = std::exp2( static_cast<double>( j ) / (1 << EXP2_BITS) );
+    }
+}
+
+const Tables tables;
+
+}
+}
+}
@@ -0,0 +1,111 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2022 University of Basel
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef Hmod_util_FastMath
+#define Hmod_util_FastMath
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace OM {
+namespace util {
+
+/** Table-driven log2, exp2 and pow.
+ *
+ * These are used by the PK/PD code in place of std::pow when built with the
+ * OM_FAST_PKPD option (off by default, since results are not bit-identical
+ * to those of the standard library). The relative error of pow is below
+ * POW_MAX_REL_ERROR for positive normal bases and results (see
+ * unittest/FastMathSuite.h); other arguments fall back to std::pow. */
+namespace fastmath {
+    /// Declared maximum relative error of pow()
+    const double POW_MAX_REL_ERROR = 1e-10;
+    
+    /// Number of table entries is 1 << LOG2_BITS (resp. EXP2_BITS)
+    const int LOG2_BITS = 8, EXP2_BITS = 8;
+    
+    /// Lookup tables, computed during static initialisation
+    struct Tables {
+        Tables();
+        /** For each interval i of the mantissa [1, 2): approximately 1 / c
+         * and exactly -log2 of that, where c is the centre of the interval. */
+        double log2Inv[1 << LOG2_BITS], log2Centre[1 << LOG2_BITS];
+        /// 2^(j / 2^EXP2_BITS)
+        double exp2Frac[1 << EXP2_BITS];
+    };
+    extern const Tables tables;
+    
+    const double LOG2_E = 1.44269504088896340736;       // 1 / ln(2)
+    const double LN_2 = 0.693147180559945309417;
+    
+    /** log2(x) for positive normal x (not checked). */
+    inline double log2( double x ){
+        uint64_t bits;
+        std::memcpy( &bits, &x, sizeof(bits) );
+        const int exponent = static_cast<int>( bits >> 52 ) - 1023;
+        const int i = static_cast<int>( (bits >> (52 - LOG2_BITS)) & ((1 << LOG2_BITS) - 1) );
+        // mantissa in [1, 2):
+        bits = (bits & UINT64_C(0x000FFFFFFFFFFFFF)) | UINT64_C(0x3FF0000000000000);
+        double m;
+        std::memcpy( &m, &bits, sizeof(m) );
+        // |r| <= 2^-(LOG2_BITS+1); log(1+r) by its Taylor series
+        const double r = m * tables.log2Inv[i] - 1.0;
+        const double log1p = r * (1.0 + r * (-1.0/2 + r * (1.0/3 + r * (-1.0/4))));
+        return exponent + (tables.log2Centre[i] + log1p * LOG2_E);
+    }
+    
+    /** 2^y for |y| < 1022 (not checked). */
+    inline double exp2( double y ){
+        // Round y to a multiple of 2^-EXP2_BITS: adding 1.5 * 2^(52-EXP2_BITS)
+        // leaves n = round(y * 2^EXP2_BITS) in the low bits of the mantissa.
+        const double shift = 6755399441055744.0 / (1 << EXP2_BITS);
+        const double shifted = y + shift;
+        uint64_t bits;
+        std::memcpy( &bits, &shifted, sizeof(bits) );
+        const double rounded = shifted - shift;
+        const int j = static_cast<int>( bits & ((1 << EXP2_BITS) - 1) );
+        // k = (n - j) / 2^EXP2_BITS, from the sign-extended low 32 bits of n:
+        const int64_t k = static_cast<int32_t>( static_cast<uint32_t>( bits ) ) >> EXP2_BITS;
+        // |u| <= ln(2) / 2^(EXP2_BITS+1); exp(u) by its Taylor series
+        const double u = (y - rounded) * LN_2;
+        const double expu = 1.0 + u * (1.0 + u * (1.0/2 + u * (1.0/6)));
+        const uint64_t scaleBits = static_cast<uint64_t>( k + 1023 ) << 52;
+        double scale;
+        std::memcpy( &scale, &scaleBits, sizeof(scale) );
+        return tables.exp2Frac[j] * expu * scale;
+    }
+    
+    /** x^y. Uses the tables when x is positive and normal and the result is
+     * well within the normal range; otherwise std::pow. */
+    inline double pow( double x, double y ){
+        if( x >= 2.2250738585072014e-308 && x <= 1.7976931348623157e308 ){
+            const double l = y * log2( x );
+            if( l > -1021.0 && l < 1021.0 ) return exp2( l );
+        }
+        return std::pow( x, y );
+    }
+}
+
+}
+}
+#endif
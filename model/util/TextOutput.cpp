@@ -0,0 +1,124 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2022 University of Basel
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "util/TextOutput.h"
+
+#include <cassert>
+#include <charconv>
+#include <cstdio>
+#include <locale>
+
+namespace OM { namespace util { namespace text {
+
+static int s_precision = 6;
+
+int precision(){
+    return s_precision;
+}
+void setPrecision( int digits ){
+    assert( digits >= 0 );
+    s_precision = digits;
+}
+
+size_t formatDouble( char* buf, double x ){
+#ifdef __cpp_lib_to_chars
+    std::to_chars_result r = s_precision == 0 ?
+        std::to_chars( buf, buf + MAX_NUMBER_LEN, x ) :
+        std::to_chars( buf, buf + MAX_NUMBER_LEN, x, std::chars_format::general, s_precision );
+    assert( r.ec == std::errc() );
+    return r.ptr - buf;
+#else
+    // Without floating-point to_chars; 17 digits read back exactly but are
+    // not always the shortest text doing so.
+    int n = std::snprintf( buf, MAX_NUMBER_LEN, "%.*g", s_precision == 0 ? 17 : s_precision, x );
+    assert( n > 0 && static_cast<size_t>(n) < MAX_NUMBER_LEN );
+    return n;
+#endif
+}
+size_t formatInt( char* buf, long long x ){
+    std::to_chars_result r = std::to_chars( buf, buf + MAX_NUMBER_LEN, x );
+    return r.ptr - buf;
+}
+size_t formatUInt( char* buf, unsigned long long x ){
+    std::to_chars_result r = std::to_chars( buf, buf + MAX_NUMBER_LEN, x );
+    return r.ptr - buf;
+}
+
+// Formats numbers with the functions above
+class NumPut : public std::num_put<char> {
+protected:
+    // Our format only matches the stream's when no formatting flags are set
+    static bool plain( std::ios_base& str ){
+        return str.width() == 0 && (str.flags() & (std::ios_base::floatfield |
+            std::ios_base::showpos | std::ios_base::showpoint |
+            std::ios_base::uppercase | std::ios_base::basefield)) ==
+            (str.flags() & std::ios_base::dec);
+    }
+    template<typename T>
+    static iter_type copy( iter_type out, T x, size_t (*format)( char*, T ) ){
+        char buf[MAX_NUMBER_LEN];
+        size_t n = format( buf, x );
+        for( size_t i = 0; i < n; ++i ) *out++ = buf[i];
+        return out;
+    }
+    iter_type do_put( iter_type out, std::ios_base& str, char_type fill, double x ) const override {
+        if( !plain( str ) ) return std::num_put<char>::do_put( out, str, fill, x );
+        return copy<double>( out, x, formatDouble );
+    }
+    iter_type do_put( iter_type out, std::ios_base& str, char_type fill, long x ) const override {
+        if( !plain( str ) ) return std::num_put<char>::do_put( out, str, fill, x );
+        return copy<long long>( out, x, formatInt );
+    }
+    iter_type do_put( iter_type out, std::ios_base& str, char_type fill, unsigned long x ) const override {
+        if( !plain( str ) ) return std::num_put<char>::do_put( out, str, fill, x );
+        return copy<unsigned long long>( out, x, formatUInt );
+    }
+};
+
+void imbue( std::ostream& stream ){
+    stream.imbue( std::locale( stream.getloc(), new NumPut ) );
+}
+
+Writer::Writer( std::ostream& sink ) :
+    sink(sink), buf(new char[BUF_SIZE]), used(0)
+{}
+Writer::~Writer(){
+    flush();
+}
+
+void Writer::flush(){
+    sink.write( buf.get(), used );
+    used = 0;
+}
+
+void Writer::write( const char* s, size_t n ){
+    if( BUF_SIZE - used < n ){
+        flush();
+        if( n > BUF_SIZE ){
+            sink.write( s, n );
+            return;
+        }
+    }
+    std::memcpy( buf.get() + used, s, n );
+    used += n;
+}
+
+} } }
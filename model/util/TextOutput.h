@@ -0,0 +1,131 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2022 University of Basel
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef Hmod_util_TextOutput
+#define Hmod_util_TextOutput
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <string>
+
+namespace OM { namespace util {
+
+/** @brief Fast formatting of numbers in text output.
+ *
+ * Numbers are converted with std::to_chars. Floating-point values use the
+ * same format as an ostream with default flags (printf's %g) with
+ * precision() significant digits, or, when the precision is 0, the shortest
+ * text which reads back as the same value. The precision is set by the
+ * --output-precision command-line option; the default, 6, matches
+ * operator<<, so output is unchanged unless the option is used. */
+namespace text {
+    /// Significant digits of floating-point values (0: shortest round-trip)
+    int precision();
+    void setPrecision( int digits );
+    
+    /// Maximum length of formatted numbers
+    const size_t MAX_NUMBER_LEN = 32;
+    
+    /// Format x into buf (of at least MAX_NUMBER_LEN chars); return the length
+    size_t formatDouble( char* buf, double x );
+    size_t formatInt( char* buf, long long x );
+    size_t formatUInt( char* buf, unsigned long long x );
+    
+    /** Make stream format numbers as above (including for operator<<, as
+     * used by callbacks writing to the stream), as long as no width or
+     * float-field flags are set. */
+    void imbue( std::ostream& stream );
+    
+    /** Writes text to a sink (any ostream: plain file or ogzstream) through
+     * a large buffer, formatting numbers as above.
+     * 
+     * Text reaches the sink when the buffer is full, on flush() and on
+     * destruction. */
+    class Writer {
+    public:
+        explicit Writer( std::ostream& sink );
+        ~Writer();
+        
+        Writer( const Writer& ) = delete;
+        Writer& operator=( const Writer& ) = delete;
+        
+        /// Write buffered text to the sink
+        void flush();
+        
+        inline Writer& operator<<( char c ){
+            if( used == BUF_SIZE ) flush();
+            buf[used++] = c;
+            return *this;
+        }
+        inline Writer& operator<<( const char* s ){
+            write( s, std::strlen( s ) );
+            return *this;
+        }
+        inline Writer& operator<<( const std::string& s ){
+            write( s.data(), s.size() );
+            return *this;
+        }
+        inline Writer& operator<<( int x ){
+            reserve();
+            used += formatInt( buf.get() + used, x );
+            return *this;
+        }
+        inline Writer& operator<<( long x ){
+            reserve();
+            used += formatInt( buf.get() + used, x );
+            return *this;
+        }
+        inline Writer& operator<<( unsigned int x ){
+            reserve();
+            used += formatUInt( buf.get() + used, x );
+            return *this;
+        }
+        inline Writer& operator<<( unsigned long x ){
+            reserve();
+            used += formatUInt( buf.get() + used, x );
+            return *this;
+        }
+        inline Writer& operator<<( double x ){
+            reserve();
+            used += formatDouble( buf.get() + used, x );
+            return *this;
+        }
+        
+        void write( const char* s, size_t n );
+        
+    private:
+        // Make sure a number fits in the buffer
+        inline void reserve(){
+            if( BUF_SIZE - used < MAX_NUMBER_LEN ) flush();
+        }
+        
+        static const size_t BUF_SIZE = 1 << 16;
+        std::ostream& sink;
+        std::unique_ptr<char[]> buf;
+        size_t used;
+    };
+}
+
+} }
+#endif
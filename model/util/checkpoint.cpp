@@ -280,28 +280,6 @@ namespace OM { namespace util { namespace checkpoint {
         }
     }
 
-    void operator& (const map<interventions::ComponentId,SimTime>& x, ostream& stream) {
-        x.size() & stream;
-        for(auto pos = x.begin (); pos != x.end() ; ++pos) {
-            pos->first & stream;
-            SimTime t = pos->second;    // use a copy: avoid const restriction
-            t & stream;
-        }
-    }
-    void operator& (map<interventions::ComponentId,SimTime>& x, istream& stream) {
-        size_t l;
-        l & stream;
-        validateListSize (l);
-        x.clear ();
-        auto pos = x.begin ();
-        for(size_t i = 0; i < l; ++i) {
-            interventions::ComponentId s( stream );
-            SimTime t = sim::never();
-            t & stream;
-            pos = x.insert (pos, make_pair (s,t));
-        }
-    }
-
     void operator& (const multimap<double,double>& x, ostream& stream) {
         x.size() & stream;
         for(auto pos = x.begin (); pos != x.end() ; ++pos) {
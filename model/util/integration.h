@@ -0,0 +1,311 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * Copyright (C) 2020-2022 University of Basel
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef Hmod_util_integration
+#define Hmod_util_integration
+
+#include <gsl/gsl_integration.h>
+#include <gsl/gsl_machine.h>
+#include <algorithm>
+#include <cmath>
+
+namespace OM {
+namespace util {
+
+/** Numeric integration of smooth functions over short intervals.
+ *
+ * integrate_qag15 gives exactly the same results as gsl_integration_qag with
+ * the 15-point Gauss-Kronrod rule (key 1), but evaluates the first
+ * Gauss-Kronrod step inline. For the smooth integrands used by the PK/PD
+ * models QAG nearly always accepts this first step; only when it does not
+ * is GSL called (which then bisects as usual).
+ *
+ * Unlike sharing a gsl_integration_workspace between callers, this is
+ * thread safe: each thread gets its own workspace for the fallback.
+ * 
+ * integrate_gl5 and integrate_hill_exp are faster alternatives which do not
+ * reproduce QAG exactly (used by the PK/PD models when built with
+ * OM_FAST_PKPD). Their documented tolerance against QAG is
+ * GL_FACTOR_REL_TOL (see unittest/IntegrationSuite.h). */
+namespace integration {
+    /// Maximum number of sub-intervals used by the QAG fallback
+    const size_t MAX_INTERVALS = 1000;
+
+    /// Abscissae of the 15-point Kronrod rule (positive half, as in GSL's qk15.c)
+    const double XGK15[8] = {
+        0.991455371120812639206854697526329,
+        0.949107912342758524526189684047851,
+        0.864864423359769072789712788640926,
+        0.741531185599394439863864773280788,
+        0.586087235467691130294144845693013,
+        0.405845151377397166906606412076961,
+        0.207784955007898467600689403773245,
+        0.000000000000000000000000000000000
+    };
+    /// Weights of the 7-point Gauss rule
+    const double WG7[4] = {
+        0.129484966168869693270611432679082,
+        0.279705391489276667901467771423780,
+        0.381830050505118944950369775488975,
+        0.417959183673469387755102040816327
+    };
+    /// Weights of the 15-point Kronrod rule
+    const double WGK15[8] = {
+        0.022935322010529224963732008058970,
+        0.063092092629978553290700663189204,
+        0.104790010322250183839876322541518,
+        0.140653259715525918745189590510238,
+        0.169004726639267902826583426598550,
+        0.190350578064785409913256402421014,
+        0.204432940075298892414161999234649,
+        0.209482141084727828012999174891714
+    };
+
+    /// Workspace for the QAG fallback, one per thread
+    inline gsl_integration_workspace* workspace(){
+        struct Holder {
+            gsl_integration_workspace *w = gsl_integration_workspace_alloc( MAX_INTERVALS );
+            ~Holder(){ gsl_integration_workspace_free( w ); }
+        };
+        static thread_local Holder holder;
+        return holder.w;
+    }
+
+    /// Error estimate of one Gauss-Kronrod step (as rescale_error in GSL)
+    inline double rescale_error( double err, double result_abs, double result_asc ){
+        err = std::fabs(err);
+        if( result_asc != 0 && err != 0 ){
+            double scale = std::pow( (200 * err / result_asc), 1.5 );
+            if( scale < 1 ) err = result_asc * scale;
+            else err = result_asc;
+        }
+        if( result_abs > GSL_DBL_MIN / (50 * GSL_DBL_EPSILON) ){
+            double min_err = 50 * GSL_DBL_EPSILON * result_abs;
+            if( min_err > err ) err = min_err;
+        }
+        return err;
+    }
+
+    template<class F>
+    double gsl_trampoline( double x, void *f ){
+        return (*static_cast<F*>( f ))( x );
+    }
+    
+    /// Abscissae of the 5-point Gauss-Legendre rule (non-negative half)
+    const double XGL5[3] = {
+        0.000000000000000000000000000000000,
+        0.538469310105683091036314420700208,
+        0.906179845938663992797626878299393
+    };
+    /// Weights of the 5-point Gauss-Legendre rule
+    const double WGL5[3] = {
+        0.568888888888888888888888888888889,
+        0.478628670499366468080626755969879,
+        0.236926885056189087514264040719917
+    };
+    /// Abscissae of the 4-point Gauss-Legendre rule (positive half)
+    const double XGL4[2] = {
+        0.339981043584856264802665759103245,
+        0.861136311594052575223946488892810
+    };
+    /// Weights of the 4-point Gauss-Legendre rule
+    const double WGL4[2] = {
+        0.652145154862546142626936050778001,
+        0.347854845137453857373063949221999
+    };
+    /// Maximum number of bisections in integrate_gl5 before using QAG
+    const int GL_MAX_DEPTH = 8;
+    
+    /** Drug factors exp(-integral) computed with integrate_gl5 (epsabs 1e-8,
+     * epsrel 1e-6) or integrate_hill_exp are within this relative tolerance
+     * of those computed with QAG, for Hill-function integrands of a
+     * concentration once absorption is (nearly) complete. Near the start of
+     * absorption both rules can miss a narrow rise, so callers use QAG there. */
+    const double GL_FACTOR_REL_TOL = 1e-6;
+    
+    /// The 5- and 4-point Gauss-Legendre rules over [a, b] (9 evaluations)
+    template<class F>
+    void gauss_legendre_54( F& f, double a, double b, double& g5, double& g4 ){
+        const double center = 0.5 * (a + b);
+        const double half_length = 0.5 * (b - a);
+        g5 = WGL5[0] * f( center );
+        g4 = 0.0;
+        for( int j = 1; j < 3; ++j ){
+            const double abscissa = half_length * XGL5[j];
+            g5 += WGL5[j] * (f( center - abscissa ) + f( center + abscissa ));
+        }
+        for( int j = 0; j < 2; ++j ){
+            const double abscissa = half_length * XGL4[j];
+            g4 += WGL4[j] * (f( center - abscissa ) + f( center + abscissa ));
+        }
+        g5 *= half_length;
+        g4 *= half_length;
+    }
+}
+
+/** Integrate f over [a, b] to the given tolerance.
+ *
+ * @param f Function object; f(x) must return a double.
+ * @param result Set to the integral
+ * @param abserr Set to the estimated absolute error
+ * @returns The GSL status code (0 on success)
+ */
+template<class F>
+int integrate_qag15( F& f, double a, double b, double epsabs, double epsrel,
+        double& result, double& abserr )
+{
+    using namespace integration;
+    // One 15-point Gauss-Kronrod step, evaluated as gsl_integration_qk does
+    const double center = 0.5 * (a + b);
+    const double half_length = 0.5 * (b - a);
+    const double abs_half_length = std::fabs(half_length);
+    const double f_center = f( center );
+
+    double result_gauss = f_center * WG7[3];
+    double result_kronrod = f_center * WGK15[7];
+    double result_abs = std::fabs(result_kronrod);
+    double fv1[7], fv2[7];
+
+    for( int j = 0; j < 3; ++j ){
+        const int jtw = j * 2 + 1;
+        const double abscissa = half_length * XGK15[jtw];
+        const double fval1 = f( center - abscissa );
+        const double fval2 = f( center + abscissa );
+        const double fsum = fval1 + fval2;
+        fv1[jtw] = fval1;
+        fv2[jtw] = fval2;
+        result_gauss += WG7[j] * fsum;
+        result_kronrod += WGK15[jtw] * fsum;
+        result_abs += WGK15[jtw] * (std::fabs(fval1) + std::fabs(fval2));
+    }
+    for( int j = 0; j < 4; ++j ){
+        const int jtwm1 = j * 2;
+        const double abscissa = half_length * XGK15[jtwm1];
+        const double fval1 = f( center - abscissa );
+        const double fval2 = f( center + abscissa );
+        fv1[jtwm1] = fval1;
+        fv2[jtwm1] = fval2;
+        result_kronrod += WGK15[jtwm1] * (fval1 + fval2);
+        result_abs += WGK15[jtwm1] * (std::fabs(fval1) + std::fabs(fval2));
+    }
+
+    const double mean = result_kronrod * 0.5;
+    double result_asc = WGK15[7] * std::fabs(f_center - mean);
+    for( int j = 0; j < 7; ++j ){
+        result_asc += WGK15[j] * (std::fabs(fv1[j] - mean) + std::fabs(fv2[j] - mean));
+    }
+
+    const double err = (result_kronrod - result_gauss) * half_length;
+    result_kronrod *= half_length;
+    result_abs *= abs_half_length;
+    result_asc *= abs_half_length;
+    const double abserr0 = rescale_error( err, result_abs, result_asc );
+
+    // The acceptance test QAG applies after its first step:
+    const double tolerance = std::max( epsabs, epsrel * std::fabs(result_kronrod) );
+    const double round_off = 50 * GSL_DBL_EPSILON * result_abs;
+    if( !(abserr0 <= round_off && abserr0 > tolerance) &&
+        ((abserr0 <= tolerance && abserr0 != result_asc) || abserr0 == 0.0) )
+    {
+        result = result_kronrod;
+        abserr = abserr0;
+        return 0;
+    }
+
+    // Otherwise let QAG subdivide (it repeats the above step, at small cost)
+    gsl_function F_gsl;
+    F_gsl.function = &gsl_trampoline<F>;
+    F_gsl.params = static_cast<void*>( &f );
+    return gsl_integration_qag( &F_gsl, a, b, epsabs, epsrel, MAX_INTERVALS,
+            GSL_INTEG_GAUSS15, workspace(), &result, &abserr );
+}
+
+namespace integration {
+    /// Add the integral over [a, b] to result, given its 5- and 4-point rules
+    template<class F>
+    int gl5_piece( F& f, double a, double b, double g5, double g4,
+            double tolerance, int depth, double& result, double& abserr )
+    {
+        const double err = std::fabs( g5 - g4 );
+        if( err <= tolerance ){
+            result += g5;
+            abserr += err;
+            return 0;
+        }
+        if( depth == 0 ){
+            double r, e;
+            int status = integrate_qag15( f, a, b, tolerance, 0.0, r, e );
+            result += r;
+            abserr += e;
+            return status;
+        }
+        const double mid = 0.5 * (a + b);
+        double g5l, g4l, g5r, g4r;
+        gauss_legendre_54( f, a, mid, g5l, g4l );
+        gauss_legendre_54( f, mid, b, g5r, g4r );
+        int status = gl5_piece( f, a, mid, g5l, g4l, 0.5 * tolerance, depth - 1, result, abserr );
+        if( status != 0 ) return status;
+        return gl5_piece( f, mid, b, g5r, g4r, 0.5 * tolerance, depth - 1, result, abserr );
+    }
+}
+
+/** Integrate f over [a, b] to the given tolerance, with the 5-point
+ * Gauss-Legendre rule and the 4-point rule for error control.
+ * 
+ * Where the two rules differ by more than the tolerance (which is split
+ * between pieces by length), the interval is bisected; pieces still not
+ * converged after GL_MAX_DEPTH bisections are integrated with
+ * integrate_qag15. For smooth integrands this usually takes 9 evaluations,
+ * against 15 for a single Gauss-Kronrod step. The error estimate is that of
+ * the 4-point rule, thus pessimistic.
+ * 
+ * Parameters and return value are as for integrate_qag15. */
+template<class F>
+int integrate_gl5( F& f, double a, double b, double epsabs, double epsrel,
+        double& result, double& abserr )
+{
+    double g5, g4;
+    integration::gauss_legendre_54( f, a, b, g5, g4 );
+    const double tolerance = std::max( epsabs, epsrel * std::fabs(g5) );
+    result = 0.0;
+    abserr = 0.0;
+    return integration::gl5_piece( f, a, b, g5, g4, tolerance, integration::GL_MAX_DEPTH, result, abserr );
+}
+
+/** Closed form of the integral over [0, duration] of the Hill function
+ * V c^n / (c^n + Kn), where c = c0 exp(lambda t).
+ * 
+ * Since d/dt log(c^n + Kn) = n lambda c^n / (c^n + Kn), the integral is
+ * V / (n lambda) log((c(duration)^n + Kn) / (c0^n + Kn)).
+ * 
+ * @param c0n c0^n
+ * @param nLambda n * lambda
+ */
+inline double integrate_hill_exp( double c0n, double nLambda, double V,
+        double Kn, double duration )
+{
+    if( nLambda == 0.0 ) return V * duration * c0n / (c0n + Kn);
+    return V / nLambda * std::log1p( c0n * std::expm1( nLambda * duration ) / (c0n + Kn) );
+}
+
+}
+}
+#endif
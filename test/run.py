@@ -162,8 +162,13 @@ def runScenario(options,omOptions,name):
     # on old Mac OS systems, lasttime seems to be rounded to the second.
     # for processes < 1 second, the checkpoint file would be written 'before lastTime.
     startTime=lastTime=time.time() - 5.0
-    # While no output.txt file and cmd exits successfully:
-    while (not os.path.isfile(outputFile)):
+    # With --checkpoint-stop the first run stops after writing a checkpoint;
+    # with --stream-output it has already created output.txt.
+    stopsAtCheckpoint = "--checkpoint-stop" in omOptions
+    nRuns = 0
+    # While no output.txt file (or not yet resumed) and cmd exits successfully:
+    while (stopsAtCheckpoint and nRuns < 2) or (not os.path.isfile(outputFile)):
+        nRuns += 1
         if options.logging:
             print("\033[0;32m  "+(" ".join(cmd))+"\033[0;00m")
         ret=subprocess.call (cmd, shell=False, cwd=simDir)
@@ -300,6 +305,8 @@ You can pass options to openMalaria by first specifying -- (to end options passe
 		    help="Don't clean up expected files from the temparary dir (checkpoint files, schema, etc.)")
     parser.add_option("-C","--no-compare", action="store_false", dest="compare", default=True,
                       help="Don't compare output after running; instead just copy outputs to test/outputXX.txt and test/ctsoutXX.txt")
+    parser.add_option("--tolerance", action="store", type="float", dest="tolerance", default=None,
+            help="Relative and absolute tolerance when comparing output values (default: that of compareOutput.py)")
     parser.add_option("-d","--diff", action="store_true", dest="diff", default=False,
             help="Launch a diff program (kdiff3) on the output if validation fails")
     parser.add_option("--valid","--validate",
@@ -323,6 +330,9 @@ You can pass options to openMalaria by first specifying -- (to end options passe
     (options, others) = parser.parse_args(args=args)
     
     options.ensure_value("wrapArgs", [])
+    if options.tolerance is not None:
+        compareOutput.REL_PRECISION = options.tolerance
+        compareOutput.ABS_PRECISION = options.tolerance
     
     toRun=set()
     for arg in others:
@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+# This file is part of OpenMalaria.
+#
+# Copyright (C) 2005-2010 Swiss Tropical Institute and Liverpool School Of Tropical Medicine
+#
+# OpenMalaria is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2 of the License, or (at
+# your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+
+# Runs scenario MSAT (which has imported infections) with the by-origin
+# uncomplicated episode measures enabled, with and without --stream-output.
+# With streaming output, episodes may be reported by the origin at expiry
+# instead of at replacement, so these measures are only checked for
+# consistency (they must sum to nUncomp); all other measures must match.
+#
+# Return values: 0 - passed, 1 - failed, -1 - unable to run
+
+import sys
+import os
+import tempfile
+import shutil
+import subprocess
+
+sys.path.insert(0,"@CMAKE_CURRENT_BINARY_DIR@")
+import run
+from approxEqual import ApproxSame
+from readOutput import readEntries
+
+UNCOMP=14
+ORIGIN_MEASURES={1014:"nUncomp_Imported", 2014:"nUncomp_Introduced", 3014:"nUncomp_Indigenous"}
+
+def simulate(omOptions):
+    """Run the scenario in a temporary directory; return the output entries."""
+    scenarioSrc=os.path.join(run.testSrcDir,"scenarioMSAT.xml")
+    with open(scenarioSrc) as f:
+        text=f.read()
+    uncomp='<option name="nUncomp" value="true"/>'
+    if not uncomp in text:
+        raise run.RunError("scenarioMSAT.xml does not enable nUncomp")
+    options="".join('\n      <option name="%s" value="true"/>' % n for n in sorted(ORIGIN_MEASURES.values()))
+
+    simDir=tempfile.mkdtemp(prefix='streamOrigins-', dir=run.testBuildDir)
+    scenario=os.path.join(simDir,"scenario.xml")
+    with open(scenario,'w') as f:
+        f.write(text.replace(uncomp,uncomp+options))
+    schemaName=run.getSchemaName(scenarioSrc)
+    scenarioSchema=os.path.join(run.testSrcDir,'../schema',schemaName)
+    if not os.path.isfile(scenarioSchema):
+        scenarioSchema=os.path.join(run.testBuildDir,'../schema',schemaName)
+    run.linkOrCopy(scenarioSchema, os.path.join(simDir,schemaName))
+
+    cmd=[run.openMalariaExec,"--resource-path",os.path.abspath(run.testSrcDir),"--scenario",scenario]+omOptions
+    print("\033[0;32m  "+(" ".join(cmd))+"\033[0;00m")
+    if subprocess.call(cmd, shell=False, cwd=simDir) != 0:
+        raise run.RunError("Non-zero exit status")
+    values=readEntries(os.path.join(simDir,"output.txt"))
+    shutil.rmtree(simDir)
+    return values
+
+def checkOriginSums(values, what):
+    """Check that each survey and age group's by-origin episodes sum to nUncomp."""
+    sums=dict()
+    for (k,v) in values.items():
+        if k.a in ORIGIN_MEASURES:
+            sums[(k.b,k.c)] = sums.get((k.b,k.c), 0.0) + v
+    nFailed=0
+    for (k,v) in values.items():
+        if k.a == UNCOMP and sums.get((k.b,k.c), 0.0) != v:
+            print("%s: survey %d, group %d: nUncomp is %g but by-origin measures sum to %g"
+                  % (what, k.b, k.c, v, sums.get((k.b,k.c), 0.0)))
+            nFailed += 1
+    return nFailed
+
+def main():
+    try:
+        plain=simulate([])
+        streamed=simulate(["--stream-output"])
+    except run.RunError as e:
+        print(str(e))
+        return -1
+
+    nFailed=checkOriginSums(plain, "without streaming")
+    nFailed+=checkOriginSums(streamed, "--stream-output")
+    approxSame=ApproxSame(1e-6, 1e-6)
+    for (k,v) in plain.items():
+        if k.a in ORIGIN_MEASURES:
+            continue
+        if not k in streamed:
+            print("measure %d, survey %d, group %d: missing with --stream-output" % (k.a, k.b, k.c))
+            nFailed += 1
+        elif not approxSame(v, streamed[k]):
+            print("measure %d, survey %d, group %d: %g without streaming, %g with --stream-output"
+                  % (k.a, k.b, k.c, v, streamed[k]))
+            nFailed += 1
+    if len(streamed) != len(plain):
+        print("--stream-output wrote %d entries, expected %d" % (len(streamed), len(plain)))
+        nFailed += 1
+
+    print("\033[1;%dm%d differences\033[0;00m" % (31 if nFailed else 32, nFailed))
+    return 1 if nFailed else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,81 @@
+/*
+ This file is part of OpenMalaria.
+ 
+ Copyright (C) 2005-2014 Swiss Tropical and Public Health Institute
+ Copyright (C) 2005-2014 Liverpool School Of Tropical Medicine
+ 
+ OpenMalaria is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or (at
+ your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+
+#ifndef Hmod_FastMathSuite
+#define Hmod_FastMathSuite
+
+#include <cxxtest/TestSuite.h>
+#include "ExtraAsserts.h"
+
+#include "util/FastMath.h"
+#include <cmath>
+
+using namespace OM::util;
+
+class FastMathSuite : public CxxTest::TestSuite
+{
+public:
+    void testPowersOfTwo() {
+        for( int e = -100; e <= 100; ++e ){
+            TS_ASSERT_APPROX_TOL( fastmath::log2( std::ldexp( 1.0, e ) ), e, 0.0, 1e-13 );
+            TS_ASSERT_EQUALS( fastmath::exp2( e ), std::ldexp( 1.0, e ) );
+        }
+    }
+    
+    // Within the declared error over the ranges used by the Hill function:
+    // concentrations (and ratios) over many orders of magnitude and
+    // slopes/killing powers up to a few hundred.
+    void testPowAccuracy() {
+        double maxErr = 0.0;
+        for( double lx = -40.0; lx <= 40.0; lx += 0.0371 ){
+            const double x = std::exp( lx );
+            for( double y = -300.0; y <= 300.0; y += 1.37 ){
+                const double expected = std::pow( x, y );
+                if( !(expected > 1e-300 && expected < 1e300) ) continue;
+                maxErr = std::max( maxErr,
+                        std::fabs( fastmath::pow( x, y ) - expected ) / expected );
+            }
+        }
+        TS_ASSERT_LESS_THAN( maxErr, fastmath::POW_MAX_REL_ERROR );
+    }
+    
+    // Ratios close to 1 with large powers, as in calcFactor
+    void testPowNearOne() {
+        for( double d = -1e-3; d <= 1e-3; d += 1.7e-6 ){
+            for( double y : { 1.6, 4.0, 57.3, 480.0 } ){
+                const double expected = std::pow( 1.0 + d, y );
+                TS_ASSERT_APPROX_TOL( fastmath::pow( 1.0 + d, y ), expected,
+                        fastmath::POW_MAX_REL_ERROR, 0.0 );
+            }
+        }
+    }
+    
+    // Other arguments use std::pow
+    void testFallback() {
+        TS_ASSERT_EQUALS( fastmath::pow( 0.0, 4.0 ), 0.0 );
+        TS_ASSERT_EQUALS( fastmath::pow( -2.0, 3.0 ), -8.0 );
+        TS_ASSERT_EQUALS( fastmath::pow( 1e-310, 0.5 ), std::pow( 1e-310, 0.5 ) );
+        TS_ASSERT_EQUALS( fastmath::pow( 1e10, 200.0 ), std::pow( 1e10, 200.0 ) );
+    }
+};
+
+#endif
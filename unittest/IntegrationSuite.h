@@ -0,0 +1,165 @@
+/*
+ This file is part of OpenMalaria.
+ 
+ Copyright (C) 2005-2014 Swiss Tropical and Public Health Institute
+ Copyright (C) 2005-2014 Liverpool School Of Tropical Medicine
+ 
+ OpenMalaria is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or (at
+ your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#ifndef Hmod_IntegrationSuite
+#define Hmod_IntegrationSuite
+
+#include <cxxtest/TestSuite.h>
+#include "ExtraAsserts.h"
+
+#include "util/integration.h"
+#include <cmath>
+
+using namespace OM::util;
+
+namespace {
+    // Concentration similar to that of a three-compartment drug after a dose
+    struct HillKilling {
+        double Kn;
+        double t0 = 0.0;    // time since the dose at t = 0
+        double operator()( double t ) const {
+            t += t0;
+            double conc = 3.0 * exp(-0.5 * t) + 0.4 * exp(-0.05 * t) - 2.9 * exp(-5.0 * t);
+            double cn = pow(conc, 2.5);
+            return 3.45 * cn / (cn + Kn);
+        }
+    };
+    
+    // Hill function of a single exponential concentration
+    struct HillExp {
+        double c0, lambda, n, Kn;
+        double operator()( double t ) const {
+            double cn = pow(c0 * exp(lambda * t), n);
+            return 3.45 * cn / (cn + Kn);
+        }
+    };
+    
+    template<class F>
+    double call_gsl( double x, void* p ){
+        return (*static_cast<F*>( p ))( x );
+    }
+}
+
+class IntegrationSuite : public CxxTest::TestSuite
+{
+public:
+    IntegrationSuite() : wksp( gsl_integration_workspace_alloc( 1000 ) ) {}
+    ~IntegrationSuite(){ gsl_integration_workspace_free( wksp ); }
+    
+    // integrate_qag15 must reproduce gsl_integration_qag exactly, both when
+    // the first step is accepted and when QAG subdivides.
+    void testSameAsQAG() {
+        const double Kns[] = { 1e-4, 0.02, 0.5, 10.0 };
+        const double durations[] = { 0.01, 0.25, 0.5, 1.0 };
+        for( double Kn : Kns ){
+            for( double duration : durations ){
+                HillKilling f{ Kn };
+                double result, abserr;
+                int r = integrate_qag15( f, 0.0, duration, 1e-5, 1e-2, result, abserr );
+                TS_ASSERT_EQUALS( r, 0 );
+                
+                double gsl_result, gsl_abserr;
+                TS_ASSERT_EQUALS( qag( f, duration, gsl_result, gsl_abserr ), 0 );
+                TS_ASSERT_EQUALS( result, gsl_result );
+                TS_ASSERT_EQUALS( abserr, gsl_abserr );
+            }
+        }
+    }
+    
+    // Drug factors exp(-integral) from integrate_gl5 are within
+    // GL_FACTOR_REL_TOL of those from QAG, once absorption is (nearly)
+    // complete (from t0 = 1 the absorption term is below 1% of conc)
+    void testGL5NearQAG() {
+        const double Kns[] = { 1e-4, 0.02, 0.5, 10.0 };
+        const double t0s[] = { 1.0, 2.0, 5.0, 10.0 };
+        const double durations[] = { 0.01, 0.25, 0.5, 1.0 };
+        for( double Kn : Kns ){
+            for( double t0 : t0s ){
+                for( double duration : durations ){
+                    HillKilling f{ Kn, t0 };
+                    double result, abserr;
+                    TS_ASSERT_EQUALS( integrate_gl5( f, 0.0, duration, 1e-8, 1e-6, result, abserr ), 0 );
+                    double gsl_result, gsl_abserr;
+                    TS_ASSERT_EQUALS( qag( f, duration, gsl_result, gsl_abserr ), 0 );
+                    TS_ASSERT_APPROX_TOL( exp(-result), exp(-gsl_result),
+                            integration::GL_FACTOR_REL_TOL, 0.0 );
+                }
+            }
+        }
+    }
+    
+    // Pieces which do not converge (here the one with the kink) are passed
+    // to QAG
+    void testGL5Fallback() {
+        auto kink = []( double t ){ return fabs(t - 0.3); };
+        double result, abserr;
+        TS_ASSERT_EQUALS( integrate_gl5( kink, 0.0, 1.0, 1e-8, 1e-6, result, abserr ), 0 );
+        TS_ASSERT_DELTA( result, 0.29, 1e-6 );
+    }
+    
+    // The closed form for a single exponential is within GL_FACTOR_REL_TOL
+    // of QAG (for drug factors)
+    void testHillExpNearQAG() {
+        const double Kns[] = { 1e-4, 0.02, 0.5, 10.0 };
+        const double c0s[] = { 0.01, 0.1, 1.0, 5.0 };
+        const double lambdas[] = { -0.05, -0.5, -5.0 };
+        const double ns[] = { 1.0, 2.5, 6.0 };
+        for( double Kn : Kns ){
+            for( double c0 : c0s ){
+                for( double lambda : lambdas ){
+                    for( double n : ns ){
+                        HillExp f{ c0, lambda, n, Kn };
+                        const double result = integrate_hill_exp( pow(c0, n), n * lambda, 3.45, Kn, 0.5 );
+                        double gsl_result, gsl_abserr;
+                        TS_ASSERT_EQUALS( qag( f, 0.5, gsl_result, gsl_abserr ), 0 );
+                        TS_ASSERT_APPROX_TOL( exp(-result), exp(-gsl_result),
+                                integration::GL_FACTOR_REL_TOL, 0.0 );
+                    }
+                }
+            }
+        }
+        // lambda = 0: constant concentration
+        TS_ASSERT_DELTA( integrate_hill_exp( 1.0, 0.0, 2.0, 1.0, 0.5 ), 0.5, 1e-15 );
+    }
+    
+    void testZero() {
+        auto f = []( double ){ return 0.0; };
+        double result, abserr;
+        TS_ASSERT_EQUALS( integrate_qag15( f, 0.0, 1.0, 1e-2, 1e-2, result, abserr ), 0 );
+        TS_ASSERT_EQUALS( result, 0.0 );
+    }
+    
+private:
+    // gsl_integration_qag over [0, b], with the tolerances used by the
+    // conversion model
+    template<class F>
+    int qag( F& f, double b, double& result, double& abserr ){
+        gsl_function F_gsl;
+        F_gsl.function = &call_gsl<F>;
+        F_gsl.params = static_cast<void*>( &f );
+        return gsl_integration_qag( &F_gsl, 0.0, b, 1e-5, 1e-2,
+                1000, GSL_INTEG_GAUSS15, wksp, &result, &abserr );
+    }
+    
+    gsl_integration_workspace *wksp;
+};
+
+#endif
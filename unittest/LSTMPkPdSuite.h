@@ -25,6 +25,7 @@
 
 #include <cxxtest/TestSuite.h>
 #include "PkPd/LSTMModel.h"
+#include "PkPd/DecayBatch.h"
 #include "Host/WithinHost/Infection/DummyInfection.h"
 #include "UnittestUtil.h"
 #include "ExtraAsserts.h"
@@ -93,6 +94,55 @@ public:
 	TS_ASSERT_APPROX (proxy->getDrugFactor (m_rng, inf, massAt21), 0.03174563637686205);
     }
     
+    // Deferred decay over days of changing body mass (as for children) must
+    // match decay applied daily
+    void testDeferredDecayVaryingMass () {
+	for( const char* abbrev : { "MQ", "AR" } ){
+	    const size_t index = LSTMDrugType::findDrug( abbrev );
+	    LSTMModel daily, deferred;
+	    m_rng.seed(0, 721347520444481703);
+	    UnittestUtil::medicate( m_rng, daily, index, 3000, 0 );
+	    m_rng.seed(0, 721347520444481703);
+	    UnittestUtil::medicate( m_rng, deferred, index, 3000, 0 );
+	    for( int day = 0; day < 5; ++day ){
+		const double mass = 10.0 + 0.25 * day;
+		daily.decayDrugs( mass );
+		daily.getDrugConc( index );	// applies decay
+		deferred.decayDrugs( mass );
+	    }
+	    TS_ASSERT_APPROX( deferred.getDrugConc( index ), daily.getDrugConc( index ) );
+	}
+    }
+    
+    // Batched decay must give exactly the results of decay applied per host
+    void testDecayBatch () {
+	const size_t AR_index = LSTMDrugType::findDrug( "AR" );
+	const size_t N = 6;
+	vector<LSTMModel> single( N ), batched( N );
+	for( size_t h = 0; h < N; ++h ){
+	    // Hosts 0-3 form a group; host 4 has a dose tomorrow; host 5 uses
+	    // the conversion model, which is not grouped
+	    const size_t index = h == 5 ? AR_index : MQ_index;
+	    const double time = h == 4 ? 1.5 : 0.0;
+	    for( LSTMModel* model : { &single[h], &batched[h] } ){
+		m_rng.seed(h, 721347520444481703);
+		UnittestUtil::medicate( m_rng, *model, index, 1000.0 + 500.0 * h, time );
+	    }
+	    for( int day = 0; day < 4; ++day ){
+		const double mass = 10.0 + h + (day < 2 ? 0.0 : 0.5);
+		single[h].decayDrugs( mass );
+		batched[h].decayDrugs( mass );
+	    }
+	}
+	DecayBatch batch;
+	for( LSTMModel& model : batched ) batch.add( model );
+	batch.apply();
+	for( size_t h = 0; h < N; ++h ){
+	    const size_t index = h == 5 ? AR_index : MQ_index;
+	    TS_ASSERT_EQUALS( batched[h].getDrugConc( index ), single[h].getDrugConc( index ) );
+	}
+    }
+    
 private:
     LocalRng m_rng;
     LSTMModel *proxy;
@@ -0,0 +1,190 @@
+/*
+ This file is part of OpenMalaria.
+ 
+ Copyright (C) 2005-2014 Swiss Tropical and Public Health Institute
+ Copyright (C) 2005-2014 Liverpool School Of Tropical Medicine
+ 
+ OpenMalaria is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or (at
+ your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+// Timed regression harness for the LSTM drug models
+
+#ifndef Hmod_PkPdTimingSuite
+#define Hmod_PkPdTimingSuite
+
+#include <cxxtest/TestSuite.h>
+#include "PkPd/LSTMModel.h"
+#include "Host/WithinHost/Infection/DummyInfection.h"
+#include "UnittestUtil.h"
+#include "ExtraAsserts.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+using namespace OM;
+using namespace OM::PkPd;
+
+/** Times the drug models (one-compartment, three-compartment and
+ * conversion) over a grid of dosing regimens, body masses and numbers of
+ * infections, reporting nanoseconds per drug-factor evaluation (including
+ * the share of medication and decay).
+ * 
+ * Skipped unless the environment variable OM_PKPD_TIMING is set (the
+ * pkpdTiming test sets it). Further variables:
+ * 
+ * OM_PKPD_TIMING_BASELINE: file of reference timings. If it exists, the
+ * test fails when any case is more than OM_PKPD_TIMING_TOLERANCE percent
+ * (default 25) slower. If OM_PKPD_TIMING_UPDATE is set, current timings
+ * are written to it instead.
+ * 
+ * OM_PKPD_TIMING_REQUIRE_BASELINE: if set, the test fails when there is no
+ * baseline (as in CI, where the baseline is restored from a stored
+ * artifact). Otherwise a missing baseline is written from current timings.
+ * 
+ * Timings are only comparable on one machine and build configuration. */
+class PkPdTimingSuite : public CxxTest::TestSuite
+{
+public:
+    PkPdTimingSuite() : m_rng(0, 0) {}
+    
+    void setUp () {
+        m_rng.seed(0, 721347520444481703);
+        UnittestUtil::initTime(1);
+        UnittestUtil::PkPdSuiteSetup();
+    }
+    void tearDown () {
+        LSTMDrugType::clear();
+    }
+    
+    void testTiming () {
+        if( getenv( "OM_PKPD_TIMING" ) == nullptr ){
+            TS_SKIP( "set OM_PKPD_TIMING to run" );
+        }
+        
+        struct Model { const char *name, *drug; double mgPerKg; };
+        const Model models[] = {
+            { "one-comp", "AR1", 1.7 },
+            { "three-comp", "PPQ3", 18.0 },
+            { "conversion", "AR", 1.7 }
+        };
+        const double masses[] = { 15.0, 50.0, 80.0 };
+        const size_t infectionCounts[] = { 1, 4, 16 };
+        
+        map<string, double> timings;
+        printf( "\n%-32s %12s\n", "case", "ns/factor" );
+        for( const Model& model : models ){
+            const size_t drugIndex = LSTMDrugType::findDrug( model.drug );
+            for( int hex = 0; hex < 2; ++hex ){
+                for( double mass : masses ){
+                    for( size_t nInfs : infectionCounts ){
+                        ostringstream key;
+                        key << model.name << '/' << (hex ? "hex" : "triple")
+                            << '/' << mass << "kg/" << nInfs << "inf";
+                        double ns = timeCase( drugIndex, model.mgPerKg * mass,
+                                hex != 0, mass, nInfs );
+                        timings[key.str()] = ns;
+                        printf( "%-32s %12.1f\n", key.str().c_str(), ns );
+                    }
+                }
+            }
+        }
+        
+        const char *baseline = getenv( "OM_PKPD_TIMING_BASELINE" );
+        const bool requireBaseline = getenv( "OM_PKPD_TIMING_REQUIRE_BASELINE" ) != nullptr;
+        if( baseline == nullptr ){
+            if( requireBaseline ) TS_FAIL( "OM_PKPD_TIMING_BASELINE not set" );
+            return;
+        }
+        ifstream in( baseline );
+        const bool update = getenv( "OM_PKPD_TIMING_UPDATE" ) != nullptr;
+        if( !in.is_open() && requireBaseline && !update ){
+            ostringstream msg;
+            msg << "no PK/PD timing baseline: " << baseline
+                << " (set OM_PKPD_TIMING_UPDATE to create one)";
+            TS_FAIL( msg.str().c_str() );
+            return;
+        }
+        if( !in.is_open() || update ){
+            in.close();
+            ofstream out( baseline );
+            for( auto& timing : timings ){
+                out << timing.first << ' ' << timing.second << '\n';
+            }
+            printf( "Wrote PK/PD timing baseline: %s\n", baseline );
+            return;
+        }
+        
+        const char *tolStr = getenv( "OM_PKPD_TIMING_TOLERANCE" );
+        const double tolerance = tolStr ? atof( tolStr ) : 25.0;
+        string key;
+        double reference;
+        while( in >> key >> reference ){
+            auto it = timings.find( key );
+            if( it == timings.end() ) continue;
+            const double slowdown = (it->second / reference - 1.0) * 100.0;
+            ostringstream msg;
+            msg << key << ": " << it->second << " ns vs baseline " << reference
+                << " ns (" << slowdown << "% slower, tolerance " << tolerance << "%)";
+            TSM_ASSERT_LESS_THAN_EQUALS( msg.str().c_str(), slowdown, tolerance );
+        }
+    }
+    
+private:
+    /** Simulate HOSTS hosts for DAYS days each, given a three-day course
+     * starting on the first day, and return the time per drug factor.
+     * The best of REPEATS runs is used, to reduce noise. */
+    double timeCase( size_t drugIndex, double dose, bool hex, double mass, size_t nInfs ){
+        const size_t HOSTS = 200, DAYS = 10, REPEATS = 5;
+        double best = numeric_limits<double>::infinity();
+        for( size_t rep = 0; rep < REPEATS; ++rep ){
+            vector<CommonInfection*> infections;
+            for( size_t i = 0; i < HOSTS * nInfs; ++i ){
+                infections.push_back( createDummyInfection( m_rng, 0, InfectionOrigin::Indigenous ) );
+            }
+            double sum = 0.0;   // used, so that the work is not optimised away
+            
+            vector<LSTMModel> pkpds( HOSTS );
+            
+            auto start = chrono::steady_clock::now();
+            for( size_t host = 0; host < HOSTS; ++host ){
+                LSTMModel& pkpd = pkpds[host];
+                for( size_t day = 0; day < DAYS; ++day ){
+                    if( day < 3 ){
+                        UnittestUtil::medicate( m_rng, pkpd, drugIndex, dose, 0.0 );
+                        if( hex ) UnittestUtil::medicate( m_rng, pkpd, drugIndex, dose, 0.5 );
+                    }
+                    for( size_t i = 0; i < nInfs; ++i ){
+                        sum += pkpd.getDrugFactor( m_rng, infections[host * nInfs + i], mass );
+                    }
+                    pkpd.decayDrugs( mass );
+                }
+            }
+            auto end = chrono::steady_clock::now();
+            
+            TS_ASSERT( sum > 0.0 );
+            for( CommonInfection *inf : infections ) delete inf;
+            double ns = chrono::duration<double, nano>( end - start ).count();
+            best = min( best, ns / (HOSTS * DAYS * nInfs) );
+        }
+        return best;
+    }
+    
+    LocalRng m_rng;
+};
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ This file is part of OpenMalaria.
+
+ Copyright (C) 2005-2014 Swiss Tropical and Public Health Institute
+ Copyright (C) 2005-2014 Liverpool School Of Tropical Medicine
+
+ OpenMalaria is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or (at
+ your option) any later version.
+
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+
+#ifndef Hmod_ReportBufferSuite
+#define Hmod_ReportBufferSuite
+
+#include <cxxtest/TestSuite.h>
+#include "ExtraAsserts.h"
+
+#include "mon/ReportBuffer.h"
+#include <vector>
+
+using namespace OM::mon;
+
+class ReportBufferSuite : public CxxTest::TestSuite
+{
+public:
+    // Reports split over buffers then merged give exactly the integer sums
+    // of adding them directly, and leave the buffers empty.
+    void testMergeIntegerSums() {
+        const size_t N = 1000, nBuffers = 4, nReports = 100000;
+        std::vector<int> direct( N, 0 ), merged( N, 0 );
+        std::vector<ReportBuffer<int>> buffers( nBuffers );
+
+        // Deterministic but irregular pattern of reports
+        size_t index = 7;
+        for( size_t i = 0; i < nReports; ++i ){
+            index = (index * 1103515245 + 12345) % N;
+            const int val = static_cast<int>( i % 13 ) - 3;
+            direct[index] += val;
+            buffers[i * nBuffers / nReports].add( index, val );
+        }
+        for( ReportBuffer<int>& b : buffers ){
+            TS_ASSERT( !b.empty() );
+            b.mergeInto( merged );
+            TS_ASSERT( b.empty() );
+        }
+        TS_ASSERT_EQUALS( merged, direct );
+
+        // Merging again adds nothing, and buffers are reusable
+        for( ReportBuffer<int>& b : buffers ) b.mergeInto( merged );
+        TS_ASSERT_EQUALS( merged, direct );
+        buffers[2].add( N - 1, 5 );
+        buffers[2].mergeInto( merged );
+        TS_ASSERT_EQUALS( merged[N - 1], direct[N - 1] + 5 );
+    }
+
+    // Only written values change; repeated indices keep their own entries
+    void testMergeSparse() {
+        std::vector<double> reports( 10, 1.0 );
+        ReportBuffer<double> b;
+        TS_ASSERT( b.empty() );
+        b.add( 6, 2.0 );
+        b.add( 3, 0.5 );
+        b.add( 6, 0.25 );
+        b.mergeInto( reports );
+        const std::vector<double> expected = { 1, 1, 1, 1.5, 1, 1, 3.25, 1, 1, 1 };
+        TS_ASSERT_EQUALS( reports, expected );
+    }
+
+    // Floating-point reports in contiguous blocks per buffer, merged in
+    // buffer order, are added in the same order as direct reports, thus
+    // give bit-identical sums.
+    void testMergeFloatOrder() {
+        const size_t N = 50, nBuffers = 3, nReports = 10000;
+        std::vector<double> direct( N, 0.0 ), merged( N, 0.0 );
+        std::vector<ReportBuffer<double>> buffers( nBuffers );
+        size_t index = 11;
+        for( size_t i = 0; i < nReports; ++i ){
+            index = (index * 1103515245 + 12345) % N;
+            const double val = 1.0 / (i + 3);
+            direct[index] += val;
+            buffers[i * nBuffers / nReports].add( index, val );
+        }
+        for( ReportBuffer<double>& b : buffers ) b.mergeInto( merged );
+        for( size_t i = 0; i < N; ++i )
+            TS_ASSERT_EQUALS( merged[i], direct[i] );
+    }
+};
+
+#endif
@@ -0,0 +1,102 @@
+/*
+ This file is part of OpenMalaria.
+
+ Copyright (C) 2005-2014 Swiss Tropical and Public Health Institute
+ Copyright (C) 2005-2014 Liverpool School Of Tropical Medicine
+
+ OpenMalaria is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or (at
+ your option) any later version.
+
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+
+#ifndef Hmod_TextOutputSuite
+#define Hmod_TextOutputSuite
+
+#include <cxxtest/TestSuite.h>
+#include "ExtraAsserts.h"
+
+#include "util/TextOutput.h"
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+using namespace OM::util;
+
+class TextOutputSuite : public CxxTest::TestSuite
+{
+public:
+    void setUp() {
+        text::setPrecision( 6 );
+    }
+    void tearDown() {
+        text::setPrecision( 6 );
+    }
+
+    // With the default precision, output must match that of a plain ostream
+    void testMatchesOstream() {
+        const double values[] = { 0.0, -0.0, 1.0, -2.5, 0.1, 1.0/3.0, 123456.0,
+            1234567.0, 1e-5, 1.5e-4, 3e100, -7.25e-300, 999999.5, 0.000123456789 };
+        for( double x : values ){
+            std::ostringstream expected, imbued, written;
+            expected << x;
+            text::imbue( imbued );
+            imbued << x;
+            {
+                text::Writer w( written );
+                w << x;
+            }
+            TS_ASSERT_EQUALS( imbued.str(), expected.str() );
+            TS_ASSERT_EQUALS( written.str(), expected.str() );
+        }
+        for( long x : { 0L, 7L, -7L, 2147483647L, -2147483647L - 1 } ){
+            std::ostringstream expected, written;
+            expected << x;
+            {
+                text::Writer w( written );
+                w << x;
+            }
+            TS_ASSERT_EQUALS( written.str(), expected.str() );
+        }
+    }
+
+    // Precision 0 gives text which reads back as the same value
+    void testRoundTrip() {
+        text::setPrecision( 0 );
+        double x = 0.1;
+        for( int i = 0; i < 1000; ++i ){
+            char buf[text::MAX_NUMBER_LEN + 1];
+            size_t n = text::formatDouble( buf, x );
+            buf[n] = '\0';
+            TS_ASSERT_EQUALS( std::strtod( buf, nullptr ), x );
+            x = x * 1.37 + 1.0 / (i + 3);
+        }
+    }
+
+    // Output larger than the buffer arrives complete and in order
+    void testWriterLargeOutput() {
+        std::ostringstream expected, written;
+        {
+            text::Writer w( written );
+            for( int i = 0; i < 20000; ++i ){
+                expected << i << '\t' << i * 0.5 << '\n';
+                w << i << '\t' << i * 0.5 << '\n';
+            }
+            w.write( "end", 3 );
+        }
+        expected << "end";
+        TS_ASSERT_EQUALS( written.str(), expected.str() );
+    }
+};
+
+#endif
@@ -38,7 +38,7 @@ double WHMock::probTransmissionToMosquito(vector<double> &, vector<double> &) co
     throw util::unimplemented_exception( "not needed in unit test" );
 }
 
-bool WHMock::summarize(Host::Human& human)const{
+bool WHMock::summarize(Host::Human& human, mon::HostSummary& summary){
     throw util::unimplemented_exception( "not needed in unit test" );
 }
 
@@ -62,7 +62,7 @@ void WHMock::treatPkPd(size_t schedule, size_t dosages, double age, double delay
     pkpd.prescribe( schedule, dosages, age, numeric_limits<double>::quiet_NaN(), delay_d );
 }
 
-void WHMock::update(Host::Human &human, LocalRng& rng, int &nNewInfs_i, int &nNewInfs_l, vector<double>& genotype_weights_i, vector<double>& genotype_weights_l, double ageInYears) {
+void WHMock::update(Host::Human &human, LocalRng& rng, int &nNewInfs_i, int &nNewInfs_l, const vector<double>& genotype_weights_i, const vector<double>& genotype_weights_l, double ageInYears) {
     throw util::unimplemented_exception( "not needed in unit test" );
 }
 
@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+# This file is part of OpenMalaria.
+#
+# Copyright (C) 2005-2010 Swiss Tropical Institute and Liverpool School Of Tropical Medicine
+#
+# OpenMalaria is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2 of the License, or (at
+# your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+
+"""Reader for binary survey output (openMalaria --binary-output).
+
+The format is documented in model/mon/BinaryOutput.h. Usage:
+
+    readBinaryOutput.py output.bin              # print as text output
+    readBinaryOutput.py output.bin out.txt      # convert to text output
+
+From Python, read() returns the measures and a dict of columns; with numpy
+installed, columns are numpy arrays (otherwise array.array)."""
+
+import array
+import gzip
+import struct
+import sys
+import unittest
+
+MAGIC = b"OMSURVEY"
+# type code: (array typecode, size in bytes)
+COLUMN_TYPES = { 1: ('i', 4), 2: ('I', 4), 3: ('d', 8) }
+
+class Measure(object):
+    __slots__ = ["outId", "isDouble", "name"]
+    def __init__(self, outId, isDouble, name):
+        self.outId = outId
+        self.isDouble = isDouble
+        self.name = name
+
+class Reader(object):
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+        self.order = '<'
+    def take(self, n):
+        if self.pos + n > len(self.data):
+            raise Exception("unexpected end of file")
+        b = self.data[self.pos:self.pos+n]
+        self.pos += n
+        return b
+    def unpack(self, fmt):
+        fmt = self.order + fmt
+        return struct.unpack(fmt, self.take(struct.calcsize(fmt)))
+    def string(self):
+        (n,) = self.unpack('B')
+        return self.take(n).decode('utf-8')
+
+def openData(fileName):
+    """Read the whole file, decompressing if gzipped."""
+    with open(fileName, 'rb') as f:
+        data = f.read()
+    if data[:2] == b'\x1f\x8b':
+        data = gzip.decompress(data)
+    return data
+
+def read(fileName):
+    """Read fileName. Returns (measures, columns), where measures is a list
+    of Measure and columns maps column name to an array of values."""
+    r = Reader(openData(fileName))
+    if r.take(8) != MAGIC:
+        raise Exception(fileName + " is not an OpenMalaria binary output file")
+    # version and byte-order mark: find byte order from the mark
+    for order in '<>':
+        r.order = order
+        r.pos = 8
+        (version, mark) = r.unpack('II')
+        if mark == 0x01020304:
+            break
+    else:
+        raise Exception("bad byte-order mark")
+    if version != 1:
+        raise Exception("unsupported format version: " + str(version))
+    swap = (r.order == '<') != (sys.byteorder == 'little')
+
+    (nCols,) = r.unpack('I')
+    colTypes = []
+    for i in range(nCols):
+        (t,) = r.unpack('B')
+        if t not in COLUMN_TYPES:
+            raise Exception("unknown column type: " + str(t))
+        colTypes.append((r.string(), COLUMN_TYPES[t]))
+    (nMeasures,) = r.unpack('I')
+    measures = []
+    for i in range(nMeasures):
+        (outId, isDouble) = r.unpack('iB')
+        measures.append(Measure(outId, isDouble != 0, r.string()))
+
+    columns = dict((name, array.array(t[0])) for (name, t) in colTypes)
+    while True:
+        (n,) = r.unpack('Q')
+        if n == 0:
+            break
+        for (name, (code, size)) in colTypes:
+            a = array.array(code)
+            a.frombytes(r.take(n * size))
+            if swap:
+                a.byteswap()
+            columns[name].extend(a)
+
+    try:
+        import numpy
+        columns = dict((name, numpy.array(a)) for (name, a) in columns.items())
+    except ImportError:
+        pass
+    return (measures, columns)
+
+def writeText(measures, columns, out):
+    """Write in the text output format (as output.txt)."""
+    isDouble = dict((m.outId, m.isDouble) for m in measures)
+    cols = [columns[name] for name in
+            ("survey", "ageGroup", "cohort", "species", "genotype", "drug", "measure", "value")]
+    for (s, a, c, sp, g, d, m, v) in zip(*cols):
+        # Second column combines categories as in the text output
+        col2 = a + sp + 1000 * c + 1000000 * (g + d)
+        value = "%g" % v if isDouble.get(m, True) else "%d" % v
+        out.write("%d\t%d\t%d\t%s\n" % (s, col2, m, value))
+
+class TestReader (unittest.TestCase):
+    def makeFile(self, order):
+        def pack(fmt, *args):
+            return struct.pack(order + fmt, *args)
+        def string(s):
+            return pack('B', len(s)) + s.encode('utf-8')
+        names = ["survey", "ageGroup", "cohort", "species", "genotype", "drug", "measure", "value"]
+        types = [2, 2, 2, 2, 2, 2, 1, 3]
+        b = MAGIC + pack('II', 1, 0x01020304) + pack('I', len(names))
+        for (n, t) in zip(names, types):
+            b += pack('B', t) + string(n)
+        b += pack('I', 2) + pack('iB', 0, 0) + string("nHost") + pack('iB', 2, 1) + string("nExpectd")
+        rows = [(1, 1, 0, 0, 0, 0, 0, 12.0), (1, 2, 0, 0, 0, 0, 2, 0.25)]
+        b += pack('Q', len(rows))
+        for (i, t) in enumerate(types):
+            code = COLUMN_TYPES[t][0]
+            b += b''.join(pack(code, row[i]) for row in rows)
+        return b + pack('Q', 0)
+    def checkRead(self, order):
+        import io, os, tempfile
+        (fd, path) = tempfile.mkstemp()
+        try:
+            with os.fdopen(fd, 'wb') as f:
+                f.write(self.makeFile(order))
+            (measures, columns) = read(path)
+        finally:
+            os.remove(path)
+        self.assertEqual([m.name for m in measures], ["nHost", "nExpectd"])
+        self.assertEqual(list(columns["ageGroup"]), [1, 2])
+        out = io.StringIO()
+        writeText(measures, columns, out)
+        self.assertEqual(out.getvalue(), "1\t1\t0\t12\n1\t2\t2\t0.25\n")
+    def testLittleEndian(self):
+        self.checkRead('<')
+    def testBigEndian(self):
+        self.checkRead('>')
+
+if __name__ == '__main__':
+    if len(sys.argv) == 2 and sys.argv[1] != "test":
+        (measures, columns) = read(sys.argv[1])
+        writeText(measures, columns, sys.stdout)
+    elif len(sys.argv) == 3:
+        (measures, columns) = read(sys.argv[1])
+        with open(sys.argv[2], 'w') as out:
+            writeText(measures, columns, out)
+    else:
+        unittest.main(argv=sys.argv[:1])